@@ -0,0 +1,248 @@
+#include "color_convert.h"
+
+#include <csetjmp>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include <jpeglib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CC_HAVE_X86 1
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// BT.601 limited range, 6비트 고정소수점 (SIMD 16비트 레인에 맞춤)
+//   R = 1.164(Y-16) + 1.596(V-128)
+//   G = 1.164(Y-16) - 0.391(U-128) - 0.813(V-128)
+//   B = 1.164(Y-16) + 2.018(U-128)
+constexpr int kY  = 74;   // 1.164 * 64
+constexpr int kVR = 102;  // 1.596 * 64
+constexpr int kUG = 25;   // 0.391 * 64
+constexpr int kVG = 52;   // 0.813 * 64
+constexpr int kUB = 129;  // 2.018 * 64
+
+inline uint8_t Clamp8(int v) { return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+// SIMD 경로는 16비트 포화 덧셈을 쓰므로 스칼라도 같은 포화를 흉내 낸다
+inline int Sat16(int v) { return v < -32768 ? -32768 : (v > 32767 ? 32767 : v); }
+
+inline void YuyvPixelPair(const uint8_t* s, uint8_t* d) {
+  const int u = s[1] - 128, v = s[3] - 128;
+  const int vr = v * kVR, ugvg = u * kUG + v * kVG, ub = u * kUB;
+  for (int k = 0; k < 2; ++k) {
+    const int y = (s[k * 2] - 16) * kY + 32;
+    d[k * 3 + 0] = Clamp8(Sat16(y + vr) >> 6);
+    d[k * 3 + 1] = Clamp8(Sat16(y - ugvg) >> 6);
+    d[k * 3 + 2] = Clamp8(Sat16(y + ub) >> 6);
+  }
+}
+
+inline void YuyvRowScalar(const uint8_t* s, uint8_t* d, int x0, int width) {
+  for (int x = x0; x + 1 < width; x += 2) YuyvPixelPair(s + x * 2, d + x * 3);
+}
+
+#if defined(CC_HAVE_X86)
+// 8픽셀(YUYV 16바이트) -> R/G/B 16비트 레인
+__attribute__((target("ssse3")))
+inline void Yuyv8(__m128i in, __m128i& r, __m128i& g, __m128i& b) {
+  const __m128i k16  = _mm_set1_epi16(16);
+  const __m128i k128 = _mm_set1_epi16(128);
+  const __m128i rnd  = _mm_set1_epi16(32);
+  __m128i y  = _mm_and_si128(in, _mm_set1_epi16(0x00ff));
+  __m128i uv = _mm_srli_epi16(in, 8);                        // U0 V0 U1 V1 ...
+  __m128i u  = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, 0xA0), 0xA0); // U0 U0 U1 U1 ...
+  __m128i v  = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, 0xF5), 0xF5); // V0 V0 V1 V1 ...
+  y = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, k16), _mm_set1_epi16(kY)), rnd);
+  u = _mm_sub_epi16(u, k128);
+  v = _mm_sub_epi16(v, k128);
+  __m128i vr = _mm_mullo_epi16(v, _mm_set1_epi16(kVR));
+  __m128i ug = _mm_add_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(kUG)),
+                             _mm_mullo_epi16(v, _mm_set1_epi16(kVG)));
+  __m128i ub = _mm_mullo_epi16(u, _mm_set1_epi16(kUB));
+  r = _mm_srai_epi16(_mm_adds_epi16(y, vr), 6);
+  g = _mm_srai_epi16(_mm_subs_epi16(y, ug), 6);
+  b = _mm_srai_epi16(_mm_adds_epi16(y, ub), 6);
+}
+
+// R/G/B 평면 16바이트씩 -> RGB24 48바이트 (pshufb 인터리브)
+struct InterleaveMasks {
+  alignas(16) int8_t m[3][3][16]; // [출력 블록][채널]
+  InterleaveMasks() {
+    for (int blk = 0; blk < 3; ++blk)
+      for (int c = 0; c < 3; ++c)
+        for (int i = 0; i < 16; ++i) {
+          int p = blk * 16 + i;
+          m[blk][c][i] = (p % 3 == c) ? (int8_t)(p / 3) : (int8_t)-128;
+        }
+  }
+};
+const InterleaveMasks kMasks;
+
+__attribute__((target("ssse3")))
+void YuyvRowSsse3(const uint8_t* s, uint8_t* d, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    Yuyv8(_mm_loadu_si128((const __m128i*)(s + x * 2)),      r0, g0, b0);
+    Yuyv8(_mm_loadu_si128((const __m128i*)(s + x * 2 + 16)), r1, g1, b1);
+    __m128i r = _mm_packus_epi16(r0, r1);
+    __m128i g = _mm_packus_epi16(g0, g1);
+    __m128i b = _mm_packus_epi16(b0, b1);
+    for (int blk = 0; blk < 3; ++blk) {
+      __m128i o = _mm_or_si128(
+        _mm_or_si128(_mm_shuffle_epi8(r, _mm_load_si128((const __m128i*)kMasks.m[blk][0])),
+                     _mm_shuffle_epi8(g, _mm_load_si128((const __m128i*)kMasks.m[blk][1]))),
+        _mm_shuffle_epi8(b, _mm_load_si128((const __m128i*)kMasks.m[blk][2])));
+      _mm_storeu_si128((__m128i*)(d + x * 3 + blk * 16), o);
+    }
+  }
+  YuyvRowScalar(s, d, x, width);
+}
+
+bool HasSsse3() {
+  static const bool ok = __builtin_cpu_supports("ssse3");
+  return ok;
+}
+#endif
+
+#if defined(__ARM_NEON)
+void YuyvRowNeon(const uint8_t* s, uint8_t* d, int width) {
+  int x = 0;
+  const int16x8_t k16 = vdupq_n_s16(16), k128 = vdupq_n_s16(128), rnd = vdupq_n_s16(32);
+  for (; x + 16 <= width; x += 16) {
+    uint8x8x4_t in = vld4_u8(s + x * 2);           // Y0 U Y1 V 평면 (각 8개 = 16픽셀)
+    int16x8_t u  = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(in.val[1])), k128);
+    int16x8_t v  = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(in.val[3])), k128);
+    int16x8_t vr = vmulq_n_s16(v, kVR);
+    int16x8_t ug = vaddq_s16(vmulq_n_s16(u, kUG), vmulq_n_s16(v, kVG));
+    int16x8_t ub = vmulq_n_s16(u, kUB);
+    uint8x8_t rr[2], gg[2], bb[2];
+    for (int k = 0; k < 2; ++k) {
+      int16x8_t y = vaddq_s16(vmulq_n_s16(vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(in.val[k * 2])), k16), kY), rnd);
+      rr[k] = vqshrun_n_s16(vqaddq_s16(y, vr), 6);
+      gg[k] = vqshrun_n_s16(vqsubq_s16(y, ug), 6);
+      bb[k] = vqshrun_n_s16(vqaddq_s16(y, ub), 6);
+    }
+    // 짝/홀 픽셀 다시 섞기
+    uint8x8x2_t r = vzip_u8(rr[0], rr[1]), g = vzip_u8(gg[0], gg[1]), b = vzip_u8(bb[0], bb[1]);
+    uint8x16x3_t o;
+    o.val[0] = vcombine_u8(r.val[0], r.val[1]);
+    o.val[1] = vcombine_u8(g.val[0], g.val[1]);
+    o.val[2] = vcombine_u8(b.val[0], b.val[1]);
+    vst3q_u8(d + x * 3, o);
+  }
+  YuyvRowScalar(s, d, x, width);
+}
+#endif
+
+} // namespace
+
+void YuyvToRgbScalar(const uint8_t* src, int src_stride, int width, int height,
+                     uint8_t* dst, int dst_stride) {
+  for (int y = 0; y < height; ++y)
+    YuyvRowScalar(src + (size_t)y * src_stride, dst + (size_t)y * dst_stride, 0, width);
+}
+
+void YuyvToRgb(const uint8_t* src, int src_stride, int width, int height,
+               uint8_t* dst, int dst_stride) {
+#if defined(CC_HAVE_X86)
+  if (HasSsse3()) {
+    for (int y = 0; y < height; ++y)
+      YuyvRowSsse3(src + (size_t)y * src_stride, dst + (size_t)y * dst_stride, width);
+    return;
+  }
+#elif defined(__ARM_NEON)
+  for (int y = 0; y < height; ++y)
+    YuyvRowNeon(src + (size_t)y * src_stride, dst + (size_t)y * dst_stride, width);
+  return;
+#endif
+  YuyvToRgbScalar(src, src_stride, width, height, dst, dst_stride);
+}
+
+// ===== MJPEG =====
+
+int MjpegScaleNum(int src_w, int src_h, int req_w, int req_h) {
+  if (req_w <= 0 || req_h <= 0) return 8;
+  for (int m = 1; m < 8; m *= 2) {
+    int w, h;
+    MjpegScaledSize(src_w, src_h, m, w, h);
+    if (w >= req_w || h >= req_h) return m;
+  }
+  return 8;
+}
+
+void MjpegScaledSize(int src_w, int src_h, int scale_num, int& out_w, int& out_h) {
+  // libjpeg 의 jdiv_round_up(image * num, 8) 과 동일
+  out_w = (src_w * scale_num + 7) / 8;
+  out_h = (src_h * scale_num + 7) / 8;
+}
+
+namespace {
+struct JpegErr {
+  jpeg_error_mgr mgr;
+  std::jmp_buf   jmp;
+};
+
+void JpegErrorExit(j_common_ptr cinfo) {
+  auto* e = reinterpret_cast<JpegErr*>(cinfo->err);
+  char msg[JMSG_LENGTH_MAX];
+  (*cinfo->err->format_message)(cinfo, msg);
+  std::cerr << "[JPEG] " << msg << "\n";
+  std::longjmp(e->jmp, 1);
+}
+
+void JpegSilent(j_common_ptr, int) {} // 손상된 MJPEG 경고 스팸 억제
+} // namespace
+
+struct MjpegDecoder::Impl {
+  jpeg_decompress_struct cinfo{};
+  JpegErr err{};
+  std::vector<JSAMPROW> rows;
+};
+
+MjpegDecoder::MjpegDecoder() : im_(std::make_unique<Impl>()) {
+  im_->cinfo.err = jpeg_std_error(&im_->err.mgr);
+  im_->err.mgr.error_exit = JpegErrorExit;
+  im_->err.mgr.emit_message = JpegSilent;
+  jpeg_create_decompress(&im_->cinfo);
+}
+
+MjpegDecoder::~MjpegDecoder() { jpeg_destroy_decompress(&im_->cinfo); }
+
+bool MjpegDecoder::decode(const uint8_t* jpg, size_t bytes, int scale_num,
+                          uint8_t* dst, int dst_w, int dst_h, int dst_stride) {
+  jpeg_decompress_struct& ci = im_->cinfo;
+  if (setjmp(im_->err.jmp)) {
+    jpeg_abort_decompress(&ci);
+    return false;
+  }
+  jpeg_mem_src(&ci, jpg, (unsigned long)bytes);
+  if (jpeg_read_header(&ci, TRUE) != JPEG_HEADER_OK) { jpeg_abort_decompress(&ci); return false; }
+
+  ci.out_color_space = JCS_RGB;
+  ci.scale_num   = (unsigned)scale_num;
+  ci.scale_denom = 8;
+  jpeg_start_decompress(&ci);
+  if ((int)ci.output_width != dst_w || (int)ci.output_height != dst_h ||
+      ci.output_components != 3) {
+    jpeg_abort_decompress(&ci);
+    return false;
+  }
+
+  // 목적지 행 포인터에 바로 스캔라인 기록 (중간 버퍼 없음)
+  im_->rows.resize(dst_h);
+  for (int y = 0; y < dst_h; ++y) im_->rows[y] = dst + (size_t)y * dst_stride;
+  while (ci.output_scanline < ci.output_height) {
+    jpeg_read_scanlines(&ci, im_->rows.data() + ci.output_scanline,
+                        ci.output_height - ci.output_scanline);
+  }
+  jpeg_finish_decompress(&ci);
+  return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 카메라 원본 포맷 -> SRGB 단일 패스 변환.
+// 결과는 호출자가 준 목적지(그래프 입력 ImageFrame 버퍼)에 바로 기록된다.
+
+// YUYV(4:2:2, BT.601 limited range) -> RGB24. width 는 짝수.
+// x86 은 SSSE3(런타임 감지), ARM 은 NEON, 그 외는 스칼라 고정소수점.
+void YuyvToRgb(const uint8_t* src, int src_stride, int width, int height,
+               uint8_t* dst, int dst_stride);
+
+// 스칼라 기준 구현 (SIMD 경로와 결과 동일)
+void YuyvToRgbScalar(const uint8_t* src, int src_stride, int width, int height,
+                     uint8_t* dst, int dst_stride);
+
+// MJPEG 요청 크기에 맞춘 DCT 축소 배율(scale/8)과 결과 크기.
+// SIMD IDCT 가 있는 1/2, 1/4, 1/8 중에서, 결과의 가로 또는 세로가 요청 크기 이상으로
+// 남는 가장 작은 배율을 고른다(req<=0 이면 원본 크기). 8/8 외 배율(6/8 등)은 오히려 느리다.
+int  MjpegScaleNum(int src_w, int src_h, int req_w, int req_h);
+void MjpegScaledSize(int src_w, int src_h, int scale_num, int& out_w, int& out_h);
+
+// libjpeg-turbo 로 MJPEG 프레임을 RGB 로 직접 디코딩 (DCT 도메인 축소 포함).
+// 디코더 상태는 프레임 간 재사용된다. 스레드 하나에서만 사용.
+class MjpegDecoder {
+public:
+  MjpegDecoder();
+  ~MjpegDecoder();
+
+  MjpegDecoder(const MjpegDecoder&) = delete;
+  MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+  // dst 크기는 MjpegScaledSize(…, scale_num) 와 같아야 한다. 실패 시 false
+  bool decode(const uint8_t* jpg, size_t bytes, int scale_num,
+              uint8_t* dst, int dst_w, int dst_h, int dst_stride);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> im_;
+};
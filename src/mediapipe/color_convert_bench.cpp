@@ -0,0 +1,185 @@
+// color_convert 벤치마크: 카메라 원본 -> SRGB 변환 한 프레임 시간 (us, 중앙값)
+//   YUYV  : 스칼라 vs 런타임 디스패치(SSSE3/NEON)
+//   MJPEG : libjpeg-turbo RGB 직접 디코딩, 요청 크기(기본 640x480)보다 크면 DCT 축소
+//   opencv: 기존 경로 (cvtColor/imdecode -> BGR, BGR->RGB). OpenCV 가 있을 때만
+// 입력은 고정 seed 의 합성 프레임(그라데이션 + 잡음). MJPEG 은 같은 그림을 품질 85 로 인코딩.
+//
+//   ./color_convert_bench [--iters=N] [--req=640x480]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <jpeglib.h>
+
+#include "color_convert.h"
+
+#if __has_include(<opencv2/imgproc.hpp>) && __has_include(<opencv2/imgcodecs.hpp>)
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#define BENCH_HAVE_OPENCV 1
+#endif
+
+namespace {
+
+int g_iters = 200;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// fn 을 반복 실행해 한 번당 시간 중앙값 (us)
+template <class F>
+double MedianUs(F&& fn) {
+  for (int i = 0; i < 3; ++i) fn();   // 캐시/페이지 워밍업
+  std::vector<int64_t> t(g_iters);
+  for (int i = 0; i < g_iters; ++i) {
+    const int64_t t0 = NowNs();
+    fn();
+    t[i] = NowNs() - t0;
+  }
+  std::nth_element(t.begin(), t.begin() + g_iters / 2, t.end());
+  return t[g_iters / 2] / 1000.0;
+}
+
+// 합성 RGB 프레임: 가로/세로 그라데이션 + 잡음 (JPEG 이 너무 잘 압축되지 않게)
+std::vector<uint8_t> MakeRgb(int w, int h) {
+  std::vector<uint8_t> rgb((size_t)w * h * 3);
+  uint32_t seed = 12345;
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x) {
+      seed = seed * 1103515245u + 12345u;
+      const int n = (int)((seed >> 16) & 15) - 8;
+      uint8_t* p = &rgb[((size_t)y * w + x) * 3];
+      p[0] = (uint8_t)std::clamp(x * 255 / w + n, 0, 255);
+      p[1] = (uint8_t)std::clamp(y * 255 / h + n, 0, 255);
+      p[2] = (uint8_t)std::clamp(((x + y) & 255) + n, 0, 255);
+    }
+  return rgb;
+}
+
+std::vector<uint8_t> MakeYuyv(int w, int h) {
+  std::vector<uint8_t> yuyv((size_t)w * h * 2);
+  uint32_t seed = 54321;
+  for (size_t i = 0; i < yuyv.size(); ++i) {
+    seed = seed * 1103515245u + 12345u;
+    yuyv[i] = (uint8_t)(16 + ((i * 7 + (seed >> 16)) % 220));
+  }
+  return yuyv;
+}
+
+std::vector<uint8_t> EncodeJpeg(const std::vector<uint8_t>& rgb, int w, int h) {
+  jpeg_compress_struct c{};
+  jpeg_error_mgr err{};
+  c.err = jpeg_std_error(&err);
+  jpeg_create_compress(&c);
+  unsigned char* out = nullptr;
+  unsigned long out_len = 0;
+  jpeg_mem_dest(&c, &out, &out_len);
+  c.image_width = w;
+  c.image_height = h;
+  c.input_components = 3;
+  c.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&c);
+  jpeg_set_quality(&c, 85, TRUE);
+  // UVC 웹캠 MJPEG 과 같은 4:2:2
+  c.comp_info[0].h_samp_factor = 2;
+  c.comp_info[0].v_samp_factor = 1;
+  jpeg_start_compress(&c, TRUE);
+  while (c.next_scanline < c.image_height) {
+    JSAMPROW row = const_cast<uint8_t*>(&rgb[(size_t)c.next_scanline * w * 3]);
+    jpeg_write_scanlines(&c, &row, 1);
+  }
+  jpeg_finish_compress(&c);
+  std::vector<uint8_t> jpg(out, out + out_len);
+  jpeg_destroy_compress(&c);
+  std::free(out);
+  return jpg;
+}
+
+void BenchYuyv(int w, int h) {
+  const std::vector<uint8_t> src = MakeYuyv(w, h);
+  std::vector<uint8_t> dst((size_t)w * h * 3);
+  const double scalar = MedianUs([&] { YuyvToRgbScalar(src.data(), w * 2, w, h, dst.data(), w * 3); });
+  const double simd = MedianUs([&] { YuyvToRgb(src.data(), w * 2, w, h, dst.data(), w * 3); });
+  std::printf("%4dx%-4d YUYV  scalar %8.0f us   simd %8.0f us   (x%.1f)\n",
+              w, h, scalar, simd, scalar / simd);
+#if defined(BENCH_HAVE_OPENCV)
+  cv::Mat yuyv(h, w, CV_8UC2, const_cast<uint8_t*>(src.data()));
+  cv::Mat bgr;
+  cv::Mat rgb(h, w, CV_8UC3, dst.data());
+  const double cv_us = MedianUs([&] {
+    cv::cvtColor(yuyv, bgr, cv::COLOR_YUV2BGR_YUYV);
+    cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
+  });
+  std::printf("%4dx%-4d YUYV  opencv (YUYV->BGR->RGB) %8.0f us\n", w, h, cv_us);
+#endif
+}
+
+void BenchMjpeg(int w, int h, int req_w, int req_h) {
+  const std::vector<uint8_t> jpg = EncodeJpeg(MakeRgb(w, h), w, h);
+  MjpegDecoder dec;
+
+  std::vector<uint8_t> full((size_t)w * h * 3);
+  const double full_us = MedianUs([&] {
+    dec.decode(jpg.data(), jpg.size(), 8, full.data(), w, h, w * 3);
+  });
+  std::printf("%4dx%-4d MJPEG %zu bytes  full %8.0f us", w, h, jpg.size(), full_us);
+
+  const int scale = MjpegScaleNum(w, h, req_w, req_h);
+  int sw, sh;
+  MjpegScaledSize(w, h, scale, sw, sh);
+  if (scale != 8) {
+    std::vector<uint8_t> small((size_t)sw * sh * 3);
+    const double small_us = MedianUs([&] {
+      dec.decode(jpg.data(), jpg.size(), scale, small.data(), sw, sh, sw * 3);
+    });
+    std::printf("   %d/8 scale (%dx%d) %8.0f us", scale, sw, sh, small_us);
+  }
+  std::printf("\n");
+#if defined(BENCH_HAVE_OPENCV)
+  // 기존 경로: imdecode(BGR) -> (요청보다 크면) resize -> BGR->RGB
+  const cv::Mat buf(1, (int)jpg.size(), CV_8UC1, const_cast<uint8_t*>(jpg.data()));
+  cv::Mat bgr, resized, rgb;
+  const double cv_us = MedianUs([&] {
+    bgr = cv::imdecode(buf, cv::IMREAD_COLOR);
+    const cv::Mat* in = &bgr;
+    if (scale != 8) {
+      cv::resize(bgr, resized, cv::Size(sw, sh), 0, 0, cv::INTER_AREA);
+      in = &resized;
+    }
+    cv::cvtColor(*in, rgb, cv::COLOR_BGR2RGB);
+  });
+  std::printf("%4dx%-4d MJPEG opencv (imdecode%s->RGB) %8.0f us\n", w, h,
+              scale != 8 ? "->resize" : "", cv_us);
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int req_w = 640, req_h = 480;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--iters=", 8) == 0) {
+      g_iters = std::max(1, std::atoi(argv[i] + 8));
+    } else if (std::strncmp(argv[i], "--req=", 6) == 0) {
+      if (std::sscanf(argv[i] + 6, "%dx%d", &req_w, &req_h) != 2) req_w = req_h = 0;
+    } else {
+      std::fprintf(stderr, "usage: %s [--iters=N] [--req=WxH]\n", argv[0]);
+      return 2;
+    }
+  }
+#if !defined(BENCH_HAVE_OPENCV)
+  std::printf("(OpenCV not found: baseline rows skipped)\n");
+#endif
+  BenchYuyv(640, 480);
+  BenchYuyv(1280, 720);
+  BenchMjpeg(640, 480, req_w, req_h);
+  BenchMjpeg(1280, 720, req_w, req_h);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "emission_scheduler.h"
+#include "latency_trace.h"
+
+#include <cstdlib>
+
+namespace {
+std::chrono::steady_clock::duration PeriodOf(double hz) {
+  if (hz <= 0.0) return std::chrono::steady_clock::duration::zero();
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(1.0 / hz));
+}
+} // namespace
+
+EmissionScheduler::EmissionScheduler(EmissionConfig cfg, std::function<void(int)> emit)
+  : cfg_(cfg), min_gap_(PeriodOf(cfg.max_hz)), keepalive_(PeriodOf(cfg.min_hz)),
+    emit_(std::move(emit)) {}
+
+EmissionScheduler::~EmissionScheduler() { stop(); }
+
+void EmissionScheduler::start() {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (running_) return;
+  running_ = true;
+  thr_ = std::thread(&EmissionScheduler::thread_, this);
+}
+
+void EmissionScheduler::stop() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!running_) return;
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thr_.joinable()) thr_.join();
+}
+
+bool EmissionScheduler::significant_(int value) const {
+  if (!has_sent_) return true;
+  if ((value == 0) != (last_sent_ == 0)) return true;
+  return std::abs(value - last_sent_) >= cfg_.change_threshold;
+}
+
+void EmissionScheduler::mark_sent_locked_(int value, Clock::time_point now) {
+  has_sent_ = true;
+  last_sent_ = value;
+  last_emit_ = now;
+  pending_ = false;
+  emitted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// mu_ 를 잡지 않은 상태에서 호출. 콜백이 블록되거나 submit() 을 다시 불러도 다른 스레드가 막히지 않는다.
+// 송출 결정이 last_emit_ 갱신과 함께 mu_ 안에서 끝나므로 두 스레드의 송출은 최소 min_gap_ 간격으로 나뉜다.
+void EmissionScheduler::dispatch_(int value, uint64_t trace_id) {
+  LatencyTrace::instance().mark(trace_id, TraceStage::kDispatch);
+  LatencyTrace::set_current(trace_id);
+  if (emit_) emit_(value);
+  LatencyTrace::set_current(0);
+}
+
+void EmissionScheduler::submit(int value, uint64_t trace_id) {
+  const auto now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    latest_value_ = value;
+    if (!significant_(value)) {
+      // 의미 없는 변화: 보류 중인 값이 있으면 최신으로만 갱신
+      if (pending_) { pending_value_ = value; pending_trace_ = trace_id; }
+      else suppressed_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    if (has_sent_ && now - last_emit_ < min_gap_) {
+      // 레이트 제한: 허용 시점에 송출 스레드가 최신 값만 내보냄
+      if (pending_) suppressed_.fetch_add(1, std::memory_order_relaxed);
+      pending_ = true;
+      pending_value_ = value;
+      pending_trace_ = trace_id;
+      cv_.notify_one();
+      return;
+    }
+    mark_sent_locked_(value, now);
+  }
+  dispatch_(value, trace_id);   // 계산 즉시 송출
+}
+
+void EmissionScheduler::thread_() {
+  std::unique_lock<std::mutex> lk(mu_);
+  while (running_) {
+    auto now = Clock::now();
+    int value;
+    uint64_t trace_id;
+    if (pending_ && now - last_emit_ >= min_gap_) {
+      value = pending_value_;
+      trace_id = pending_trace_;
+    } else if (has_sent_ && keepalive_ > Clock::duration::zero() && now - last_emit_ >= keepalive_) {
+      value = latest_value_;
+      trace_id = 0;
+    } else {
+      Clock::time_point wake = now + std::chrono::seconds(1);
+      if (pending_) wake = last_emit_ + min_gap_;
+      else if (has_sent_ && keepalive_ > Clock::duration::zero()) wake = last_emit_ + keepalive_;
+      cv_.wait_until(lk, wake);
+      continue;
+    }
+    mark_sent_locked_(value, now);
+    lk.unlock();
+    dispatch_(value, trace_id);
+    lk.lock();
+  }
+}
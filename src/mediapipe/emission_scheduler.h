@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// 랜드마크 도착 시점에 값을 바로 내보내는 이벤트 기반 송출 스케줄러.
+//  - max_hz : 최대 송출 빈도. 제한에 걸린 값은 보류했다가 허용 시점에 최신 값만 송출
+//  - min_hz : 변화가 없어도 이 빈도로 마지막 값을 재전송 (keepalive, 0 이면 끔)
+//  - change_threshold : 마지막 송출 값과의 차이가 이보다 작으면 송출 생략 (0 <-> 비0 전환은 항상 송출)
+struct EmissionConfig {
+  double max_hz = 30.0;
+  double min_hz = 2.0;
+  int    change_threshold = 2;
+};
+
+class EmissionScheduler {
+public:
+  EmissionScheduler(EmissionConfig cfg, std::function<void(int)> emit);
+  ~EmissionScheduler();
+
+  void start();
+  void stop();
+
+  // 새 값 도착. trace_id 는 값의 근거가 된 프레임 (LatencyTrace)
+  void submit(int value, uint64_t trace_id);
+
+  uint64_t emitted() const    { return emitted_.load(std::memory_order_relaxed); }
+  uint64_t suppressed() const { return suppressed_.load(std::memory_order_relaxed); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void thread_();
+  void mark_sent_locked_(int value, Clock::time_point now);   // 송출 상태 갱신 (mu_ 보유)
+  void dispatch_(int value, uint64_t trace_id);               // emit_ 호출 (mu_ 미보유)
+  bool significant_(int value) const;
+
+  const EmissionConfig cfg_;
+  const Clock::duration min_gap_;     // 1/max_hz
+  const Clock::duration keepalive_;   // 1/min_hz
+  std::function<void(int)> emit_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  std::thread thr_;
+
+  // mu_ 보호
+  bool     has_sent_ = false;
+  int      last_sent_ = 0;
+  Clock::time_point last_emit_{};
+  bool     pending_ = false;
+  int      pending_value_ = 0;
+  uint64_t pending_trace_ = 0;
+  int      latest_value_ = 0;          // 임계값 미만 변화 포함 최신 값 (keepalive 용)
+
+  std::atomic<uint64_t> emitted_{0};
+  std::atomic<uint64_t> suppressed_{0};
+};
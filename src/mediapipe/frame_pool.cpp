@@ -0,0 +1,88 @@
+#include "frame_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using ::mediapipe::ImageFrame;
+
+namespace {
+constexpr size_t kBufAlign = 64; // 캐시 라인 (ImageFrame 기본 16B 정렬 만족)
+
+size_t RoundUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+} // namespace
+
+struct ImageFramePool::Shared {
+  int w = 0, h = 0, step = 0;
+  size_t bytes = 0;
+  size_t max_free = 0;
+
+  std::mutex mu;
+  std::vector<uint8_t*> free_list;
+
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+
+  uint8_t* alloc() {
+    return static_cast<uint8_t*>(std::aligned_alloc(kBufAlign, bytes));
+  }
+
+  void release(uint8_t* p) {
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      if (free_list.size() < max_free) { free_list.push_back(p); return; }
+    }
+    std::free(p);
+  }
+
+  ~Shared() {
+    for (auto* p : free_list) std::free(p);
+  }
+};
+
+ImageFramePool::ImageFramePool(int width, int height, int prealloc, int max_free)
+  : sh_(std::make_shared<Shared>()) {
+  sh_->w = width;
+  sh_->h = height;
+  sh_->step = (int)RoundUp((size_t)width * 3, ImageFrame::kDefaultAlignmentBoundary);
+  sh_->bytes = RoundUp((size_t)sh_->step * height, kBufAlign);
+  sh_->max_free = (size_t)std::max(max_free, prealloc);
+  sh_->free_list.reserve(sh_->max_free);
+  for (int i = 0; i < prealloc; ++i) {
+    uint8_t* p = sh_->alloc();
+    if (!p) break;
+    std::memset(p, 0, sh_->bytes); // 페이지 미리 매핑
+    sh_->free_list.push_back(p);
+  }
+}
+
+ImageFramePool::~ImageFramePool() = default;
+
+std::unique_ptr<ImageFrame> ImageFramePool::acquire() {
+  uint8_t* p = nullptr;
+  {
+    std::lock_guard<std::mutex> lk(sh_->mu);
+    if (!sh_->free_list.empty()) { p = sh_->free_list.back(); sh_->free_list.pop_back(); }
+  }
+  if (p) {
+    sh_->hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    sh_->misses.fetch_add(1, std::memory_order_relaxed);
+    p = sh_->alloc();
+    if (!p) return nullptr;
+  }
+  std::shared_ptr<Shared> sh = sh_;
+  return std::make_unique<ImageFrame>(
+    mediapipe::ImageFormat::SRGB, sh_->w, sh_->h, sh_->step, p,
+    [sh](uint8_t* q) { sh->release(q); });
+}
+
+int ImageFramePool::width() const      { return sh_->w; }
+int ImageFramePool::height() const     { return sh_->h; }
+int ImageFramePool::width_step() const { return sh_->step; }
+
+uint64_t ImageFramePool::hits() const   { return sh_->hits.load(std::memory_order_relaxed); }
+uint64_t ImageFramePool::misses() const { return sh_->misses.load(std::memory_order_relaxed); }
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "mediapipe/framework/formats/image_frame.h"
+
+// 그래프 입력용 SRGB ImageFrame 픽셀 버퍼 풀.
+// acquire()로 받은 프레임은 커스텀 deleter를 가지고 있어서, 그래프가 패킷을
+// 해제하는 순간 버퍼가 풀로 돌아온다(프레임마다 ~1MB malloc/free, 페이지 폴트 제거).
+class ImageFramePool {
+public:
+  // prealloc: 미리 만들어 두고 페이지까지 건드려 둘 버퍼 수
+  // max_free: 풀에 보관할 최대 버퍼 수(초과분은 해제)
+  ImageFramePool(int width, int height, int prealloc = 3, int max_free = 6);
+  ~ImageFramePool();
+
+  ImageFramePool(const ImageFramePool&) = delete;
+  ImageFramePool& operator=(const ImageFramePool&) = delete;
+
+  // 풀 버퍼를 감싼 ImageFrame 반환 (풀이 비어 있으면 새로 할당 = miss)
+  std::unique_ptr<mediapipe::ImageFrame> acquire();
+
+  int width() const;
+  int height() const;
+  int width_step() const;
+
+  // 통계
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+private:
+  // 패킷이 풀보다 오래 살아남을 수 있으므로 deleter 와 공유하는 상태
+  struct Shared;
+  std::shared_ptr<Shared> sh_;
+};
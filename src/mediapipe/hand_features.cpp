@@ -0,0 +1,183 @@
+#include "hand_features.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const int kPalmIdx[6] = {kWrist, kThumbCmc, kIndexMcp, kMiddleMcp, kRingMcp, kPinkyMcp};
+const int kTips[5] = {kThumbTip, kIndexTip, kMiddleTip, kRingTip, kPinkyTip};
+
+// 손가락 체인 (손목 -> 손끝). 관절 j 의 각도는 (prev, j, next) 세 점으로 계산
+const int kChains[5][5] = {
+  {kWrist, kThumbCmc,  kThumbMcp,  kThumbIp,   kThumbTip},
+  {kWrist, kIndexMcp,  kIndexPip,  kIndexDip,  kIndexTip},
+  {kWrist, kMiddleMcp, kMiddlePip, kMiddleDip, kMiddleTip},
+  {kWrist, kRingMcp,   kRingPip,   kRingDip,   kRingTip},
+  {kWrist, kPinkyMcp,  kPinkyPip,  kPinkyDip,  kPinkyTip},
+};
+
+// 커널용 인덱스 테이블 (4의 배수로 패딩)
+struct Tables {
+  int pair_a[12], pair_b[12];
+  int ang_p[16], ang_j[16], ang_n[16];
+  Tables() {
+    int k = 0;
+    for (int i = 0; i < 5; ++i)
+      for (int j = i + 1; j < 5; ++j) { pair_a[k] = kTips[i]; pair_b[k] = kTips[j]; ++k; }
+    for (; k < 12; ++k) { pair_a[k] = kWrist; pair_b[k] = kMiddleMcp; }
+    k = 0;
+    for (int f = 0; f < 5; ++f)
+      for (int j = 1; j <= 3; ++j) {
+        ang_p[k] = kChains[f][j - 1]; ang_j[k] = kChains[f][j]; ang_n[k] = kChains[f][j + 1]; ++k;
+      }
+    ang_p[k] = kWrist; ang_j[k] = kIndexMcp; ang_n[k] = kIndexPip;
+  }
+};
+const Tables kT;
+
+// 인덱스 테이블로 SoA 좌표를 모아 연속 배열로 (aspect 보정 포함)
+template <int N>
+inline void Gather(const HandLandmarks& h, const int* idx, float aspect,
+                   float* gx, float* gy, float* gz) {
+  for (int i = 0; i < N; ++i) {
+    gx[i] = h.x[idx[i]] * aspect;
+    gy[i] = h.y[idx[i]];
+    gz[i] = h.z[idx[i]] * aspect;
+  }
+}
+
+// acos 다항 근사 (Abramowitz & Stegun 4.4.45, 오차 < 7e-5 rad)
+inline float AcosApprox(float x) {
+  float ax = std::fabs(x);
+  float r = std::sqrt(1.f - ax) * (1.5707288f + ax * (-0.2121144f + ax * (0.0742610f - 0.0187293f * ax)));
+  return x < 0.f ? 3.14159265f - r : r;
+}
+
+#if defined(__SSE2__)
+inline __m128 AcosApprox4(__m128 x) {
+  const __m128 sign = _mm_set1_ps(-0.f);
+  __m128 ax = _mm_andnot_ps(sign, x);
+  __m128 p = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(ax, _mm_set1_ps(-0.0187293f)));
+  p = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(ax, p));
+  p = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(ax, p));
+  __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.f), ax)), p);
+  __m128 neg = _mm_cmplt_ps(x, _mm_setzero_ps());
+  __m128 rn = _mm_sub_ps(_mm_set1_ps(3.14159265f), r);
+  return _mm_or_ps(_mm_and_ps(neg, rn), _mm_andnot_ps(neg, r));
+}
+#endif
+
+} // namespace
+
+void PadLandmarks(HandLandmarks& h) {
+  for (int i = kNumLandmarks; i < kLandmarkPad; ++i) {
+    h.x[i] = h.x[kWrist]; h.y[i] = h.y[kWrist]; h.z[i] = h.z[kWrist];
+  }
+}
+
+void PalmCentroid(const HandLandmarks& h, float& cx, float& cy) {
+  float sx = 0.f, sy = 0.f;
+  for (int i : kPalmIdx) { sx += h.x[i]; sy += h.y[i]; }
+  cx = sx * (1.f / 6.f);
+  cy = sy * (1.f / 6.f);
+}
+
+void BoundingBox(const HandLandmarks& h, HandBox& box) {
+#if defined(__SSE2__)
+  __m128 mnx = _mm_load_ps(h.x), mxx = mnx, mny = _mm_load_ps(h.y), mxy = mny;
+  for (int i = 4; i < kLandmarkPad; i += 4) {
+    __m128 vx = _mm_load_ps(h.x + i), vy = _mm_load_ps(h.y + i);
+    mnx = _mm_min_ps(mnx, vx); mxx = _mm_max_ps(mxx, vx);
+    mny = _mm_min_ps(mny, vy); mxy = _mm_max_ps(mxy, vy);
+  }
+  alignas(16) float a[4], b[4], c[4], d[4];
+  _mm_store_ps(a, mnx); _mm_store_ps(b, mxx); _mm_store_ps(c, mny); _mm_store_ps(d, mxy);
+  box = {std::fmin(std::fmin(a[0], a[1]), std::fmin(a[2], a[3])),
+         std::fmin(std::fmin(c[0], c[1]), std::fmin(c[2], c[3])),
+         std::fmax(std::fmax(b[0], b[1]), std::fmax(b[2], b[3])),
+         std::fmax(std::fmax(d[0], d[1]), std::fmax(d[2], d[3]))};
+#else
+  box = {h.x[0], h.y[0], h.x[0], h.y[0]};
+  for (int i = 1; i < kLandmarkPad; ++i) {
+    box.min_x = std::fmin(box.min_x, h.x[i]); box.max_x = std::fmax(box.max_x, h.x[i]);
+    box.min_y = std::fmin(box.min_y, h.y[i]); box.max_y = std::fmax(box.max_y, h.y[i]);
+  }
+#endif
+}
+
+float HandScale(const HandLandmarks& h, float aspect) {
+  float dx = (h.x[kMiddleMcp] - h.x[kWrist]) * aspect;
+  float dy =  h.y[kMiddleMcp] - h.y[kWrist];
+  float dz = (h.z[kMiddleMcp] - h.z[kWrist]) * aspect;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void FingertipDistances(const HandLandmarks& h, float aspect, float out[kNumTipPairs]) {
+  alignas(16) float ax[12], ay[12], az[12], bx[12], by[12], bz[12], d[12];
+  Gather<12>(h, kT.pair_a, aspect, ax, ay, az);
+  Gather<12>(h, kT.pair_b, aspect, bx, by, bz);
+#if defined(__SSE2__)
+  for (int i = 0; i < 12; i += 4) {
+    __m128 dx = _mm_sub_ps(_mm_load_ps(ax + i), _mm_load_ps(bx + i));
+    __m128 dy = _mm_sub_ps(_mm_load_ps(ay + i), _mm_load_ps(by + i));
+    __m128 dz = _mm_sub_ps(_mm_load_ps(az + i), _mm_load_ps(bz + i));
+    __m128 s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    _mm_store_ps(d + i, _mm_sqrt_ps(s));
+  }
+#else
+  for (int i = 0; i < 12; ++i) {
+    float dx = ax[i] - bx[i], dy = ay[i] - by[i], dz = az[i] - bz[i];
+    d[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+  }
+#endif
+  for (int i = 0; i < kNumTipPairs; ++i) out[i] = d[i];
+}
+
+void JointAngles(const HandLandmarks& h, float aspect, float out[kNumJointAngles]) {
+  alignas(16) float px[16], py[16], pz[16], jx[16], jy[16], jz[16], nx[16], ny[16], nz[16], r[16];
+  Gather<16>(h, kT.ang_p, aspect, px, py, pz);
+  Gather<16>(h, kT.ang_j, aspect, jx, jy, jz);
+  Gather<16>(h, kT.ang_n, aspect, nx, ny, nz);
+  // 굽힘 각 = pi - (j->p, j->n 사이 각) = acos(dot(p->j, j->n) / |p->j||j->n|)
+#if defined(__SSE2__)
+  const __m128 eps = _mm_set1_ps(1e-12f), one = _mm_set1_ps(1.f), mone = _mm_set1_ps(-1.f);
+  for (int i = 0; i < 16; i += 4) {
+    __m128 jxv = _mm_load_ps(jx + i), jyv = _mm_load_ps(jy + i), jzv = _mm_load_ps(jz + i);
+    __m128 ux = _mm_sub_ps(jxv, _mm_load_ps(px + i));
+    __m128 uy = _mm_sub_ps(jyv, _mm_load_ps(py + i));
+    __m128 uz = _mm_sub_ps(jzv, _mm_load_ps(pz + i));
+    __m128 vx = _mm_sub_ps(_mm_load_ps(nx + i), jxv);
+    __m128 vy = _mm_sub_ps(_mm_load_ps(ny + i), jyv);
+    __m128 vz = _mm_sub_ps(_mm_load_ps(nz + i), jzv);
+    __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ux, vx), _mm_mul_ps(uy, vy)), _mm_mul_ps(uz, vz));
+    __m128 uu  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ux, ux), _mm_mul_ps(uy, uy)), _mm_mul_ps(uz, uz));
+    __m128 vv  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+    __m128 c = _mm_div_ps(dot, _mm_sqrt_ps(_mm_max_ps(_mm_mul_ps(uu, vv), eps)));
+    c = _mm_min_ps(one, _mm_max_ps(mone, c));
+    _mm_store_ps(r + i, AcosApprox4(c));
+  }
+#else
+  for (int i = 0; i < 16; ++i) {
+    float ux = jx[i] - px[i], uy = jy[i] - py[i], uz = jz[i] - pz[i];
+    float vx = nx[i] - jx[i], vy = ny[i] - jy[i], vz = nz[i] - jz[i];
+    float dot = ux * vx + uy * vy + uz * vz;
+    float c = dot / std::sqrt(std::fmax((ux * ux + uy * uy + uz * uz) * (vx * vx + vy * vy + vz * vz), 1e-12f));
+    r[i] = AcosApprox(std::fmin(1.f, std::fmax(-1.f, c)));
+  }
+#endif
+  for (int i = 0; i < kNumJointAngles; ++i) out[i] = r[i];
+}
+
+void ComputeHandFeatures(const HandLandmarks& h, float aspect, HandFeatures& f) {
+  PalmCentroid(h, f.palm_x, f.palm_y);
+  BoundingBox(h, f.box);
+  f.scale = HandScale(h, aspect);
+  FingertipDistances(h, aspect, f.tip_dist);
+  const float inv = f.scale > 1e-6f ? 1.f / f.scale : 0.f;
+  for (float& d : f.tip_dist) d *= inv;
+  JointAngles(h, aspect, f.joint_angle);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "landmark_snapshot.h"
+
+// HandLandmarks(SoA) 위의 벡터화 특징 커널.
+// aspect = 이미지 가로/세로. x, z 에 곱해서 세 축을 "이미지 높이" 단위로 맞춘다.
+
+// MediaPipe 손 랜드마크 인덱스
+enum HandLandmarkIndex {
+  kWrist = 0,
+  kThumbCmc = 1, kThumbMcp = 2, kThumbIp = 3, kThumbTip = 4,
+  kIndexMcp = 5, kIndexPip = 6, kIndexDip = 7, kIndexTip = 8,
+  kMiddleMcp = 9, kMiddlePip = 10, kMiddleDip = 11, kMiddleTip = 12,
+  kRingMcp = 13, kRingPip = 14, kRingDip = 15, kRingTip = 16,
+  kPinkyMcp = 17, kPinkyPip = 18, kPinkyDip = 19, kPinkyTip = 20,
+};
+
+constexpr int kNumTipPairs = 10;    // 손끝 5개 조합
+constexpr int kNumJointAngles = 15; // 손가락 5개 x 관절 3개 (MCP/PIP/DIP, 엄지는 CMC/MCP/IP)
+
+struct HandBox { float min_x, min_y, max_x, max_y; };
+
+struct HandFeatures {
+  float    palm_x, palm_y;                  // 손바닥 중심 (정규화 좌표)
+  HandBox  box;                             // 정규화 좌표
+  float    scale;                           // 손목 -> 중지 MCP 거리 (이미지 높이 단위)
+  float    tip_dist[kNumTipPairs];          // scale 로 나눈 손끝 쌍 거리 (0-1,0-2,...,3-4; 엄지=0)
+  float    joint_angle[kNumJointAngles];    // 관절 굽힘 각 (rad, 0 = 완전히 폄)
+};
+
+// 그래프 출력 한 손을 SoA 로 옮긴 뒤 패딩 칸을 채운다
+void PadLandmarks(HandLandmarks& h);
+
+void  PalmCentroid(const HandLandmarks& h, float& cx, float& cy);
+void  BoundingBox(const HandLandmarks& h, HandBox& box);
+float HandScale(const HandLandmarks& h, float aspect);
+void  FingertipDistances(const HandLandmarks& h, float aspect, float out[kNumTipPairs]);
+void  JointAngles(const HandLandmarks& h, float aspect, float out[kNumJointAngles]);
+
+// 위 커널 전부
+void ComputeHandFeatures(const HandLandmarks& h, float aspect, HandFeatures& f);
@@ -0,0 +1,103 @@
+// hand_features 벤치마크: SoA 특징 커널 한 번 호출 시간 (ns, 배치 중앙값)
+//   손 하나당 커널별 시간과 손 두 개 ComputeHandFeatures 전체(프레임당) 시간.
+// 입력은 펼친 손 모양 + 고정 seed 잡음의 합성 랜드마크. aspect = 640/480.
+//
+//   ./hand_features_bench [--batches=N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "hand_features.h"
+
+namespace {
+
+constexpr int kBatch = 10000;   // 배치 하나의 호출 수
+int g_batches = 50;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 결과를 컴파일러가 버리지 못하게
+template <class T>
+inline void Keep(T& v) { asm volatile("" : : "r"(&v) : "memory"); }
+
+template <class F>
+double MedianNs(F&& fn) {
+  std::vector<double> t(g_batches);
+  for (int i = 0; i < kBatch; ++i) fn();   // 워밍업
+  for (int b = 0; b < g_batches; ++b) {
+    const int64_t t0 = NowNs();
+    for (int i = 0; i < kBatch; ++i) fn();
+    t[b] = (double)(NowNs() - t0) / kBatch;
+  }
+  std::nth_element(t.begin(), t.begin() + g_batches / 2, t.end());
+  return t[g_batches / 2];
+}
+
+// 펼친 오른손 (정규화 좌표). 손목 -> 손끝 방향이 위쪽
+void MakeHand(HandLandmarks& h, float cx, float cy, uint32_t seed) {
+  static const float kShape[kNumLandmarks][3] = {
+    {0.00f, 0.00f, 0.00f},                                                   // wrist
+    {-0.04f, -0.03f, -0.01f}, {-0.07f, -0.07f, -0.02f}, {-0.09f, -0.11f, -0.02f}, {-0.11f, -0.14f, -0.03f},
+    {-0.03f, -0.12f, 0.00f},  {-0.035f, -0.17f, -0.01f}, {-0.04f, -0.20f, -0.02f}, {-0.045f, -0.23f, -0.02f},
+    {0.00f, -0.13f, 0.00f},   {0.00f, -0.19f, -0.01f},  {0.00f, -0.22f, -0.02f},  {0.00f, -0.25f, -0.02f},
+    {0.03f, -0.12f, 0.00f},   {0.035f, -0.17f, -0.01f}, {0.04f, -0.20f, -0.02f},  {0.045f, -0.22f, -0.02f},
+    {0.06f, -0.10f, 0.00f},   {0.07f, -0.14f, -0.01f},  {0.075f, -0.16f, -0.02f}, {0.08f, -0.18f, -0.02f},
+  };
+  for (int i = 0; i < kNumLandmarks; ++i) {
+    seed = seed * 1103515245u + 12345u;
+    const float n = ((float)((seed >> 16) & 1023) / 1023.f - 0.5f) * 0.004f;
+    h.x[i] = cx + kShape[i][0] + n;
+    h.y[i] = cy + kShape[i][1] - n;
+    h.z[i] = kShape[i][2] + n;
+  }
+  PadLandmarks(h);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--batches=", 10) == 0) {
+      g_batches = std::max(1, std::atoi(argv[i] + 10));
+    } else {
+      std::fprintf(stderr, "usage: %s [--batches=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  HandLandmarks hands[2];
+  MakeHand(hands[0], 0.35f, 0.70f, 1);
+  MakeHand(hands[1], 0.65f, 0.72f, 2);
+  const float aspect = 640.f / 480.f;
+  const HandLandmarks& h = hands[0];
+
+  float cx, cy, scale, dist[kNumTipPairs], ang[kNumJointAngles];
+  HandBox box;
+  HandFeatures f[2];
+
+  std::printf("per hand:\n");
+  std::printf("  palm centroid       %6.1f ns\n",
+              MedianNs([&] { PalmCentroid(h, cx, cy); Keep(cx); Keep(cy); }));
+  std::printf("  bounding box        %6.1f ns\n",
+              MedianNs([&] { BoundingBox(h, box); Keep(box); }));
+  std::printf("  hand scale          %6.1f ns\n",
+              MedianNs([&] { scale = HandScale(h, aspect); Keep(scale); }));
+  std::printf("  fingertip distances %6.1f ns\n",
+              MedianNs([&] { FingertipDistances(h, aspect, dist); Keep(dist); }));
+  std::printf("  joint angles        %6.1f ns\n",
+              MedianNs([&] { JointAngles(h, aspect, ang); Keep(ang); }));
+  std::printf("per frame (2 hands):\n");
+  std::printf("  all features        %6.1f ns\n", MedianNs([&] {
+                for (int k = 0; k < 2; ++k) ComputeHandFeatures(hands[k], aspect, f[k]);
+                Keep(f);
+              }));
+  return 0;
+}
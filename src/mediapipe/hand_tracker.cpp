@@ -1,5 +1,14 @@
 #include "hand_tracker.h"
-
+#include "color_convert.h"
+#include "emission_scheduler.h"
+#include "frame_pool.h"
+#include "hand_features.h"
+#include "landmark_snapshot.h"
+#include "latency_trace.h"
+#include "palm_filter.h"
+#include "v4l2_capture.h"
+
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -8,7 +17,10 @@
 #include <atomic>
 #include <cmath>
 #include <sstream>
+#include <iomanip>
 #include <thread>
+#include <condition_variable>
+#include <deque>
 
 // OpenCV
 #include <opencv2/opencv.hpp>
@@ -21,6 +33,8 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <linux/videodev2.h>
+
 using ::mediapipe::CalculatorGraph;
 using ::mediapipe::ImageFrame;
 using ::mediapipe::Packet;
@@ -29,26 +43,53 @@ using ::mediapipe::NormalizedLandmarkList;
 namespace {
 
 // util
-std::unique_ptr<ImageFrame> MatToImageFrameRGB(const cv::Mat& bgr) {
-  auto frame = std::make_unique<ImageFrame>(
-    mediapipe::ImageFormat::SRGB, bgr.cols, bgr.rows,
-    ImageFrame::kDefaultAlignmentBoundary);
-  cv::Mat dst(frame->Height(), frame->Width(), CV_8UC3, frame->MutablePixelData());
+// BGR -> RGB 스위즐을 풀 버퍼에 바로 기록 (bgr 크기 == 풀 크기)
+std::unique_ptr<ImageFrame> MatToImageFrameRGB(const cv::Mat& bgr, ImageFramePool& pool) {
+  auto frame = pool.acquire();
+  if (!frame) return nullptr;
+  cv::Mat dst(frame->Height(), frame->Width(), CV_8UC3,
+              frame->MutablePixelData(), frame->WidthStep());
   cv::cvtColor(bgr, dst, cv::COLOR_BGR2RGB);
   return frame;
 }
 
-cv::Point2f ComputePalmCenterPx(const NormalizedLandmarkList& lm, int w, int h) {
-  static const int idxs[] = {0, 1, 5, 9, 13, 17};
-  float sx = 0.f, sy = 0.f; int cnt = 0;
-  for (int i : idxs) if (i < lm.landmark_size()) {
-    const auto& p = lm.landmark(i);
-    sx += p.x() * w; sy += p.y() * h; ++cnt;
+// V4L2 드라이버 버퍼 -> 풀 RGB 프레임 단일 패스 변환.
+// YUYV 는 SIMD 커널, MJPEG 는 libjpeg-turbo 가 (필요 시 DCT 축소하며) 풀 버퍼에 직접 RGB 로 기록
+std::unique_ptr<ImageFrame> V4l2FrameToImageFrameRGB(const V4l2Frame& raw, ImageFramePool& pool,
+                                                     MjpegDecoder& jpeg, int mjpeg_scale) {
+  auto frame = pool.acquire();
+  if (!frame) return nullptr;
+  if (raw.fourcc == V4L2_PIX_FMT_YUYV) {
+    if (raw.width != frame->Width() || raw.height != frame->Height()) return nullptr;
+    YuyvToRgb(raw.data, raw.stride, raw.width, raw.height,
+              frame->MutablePixelData(), frame->WidthStep());
+  } else if (raw.fourcc == V4L2_PIX_FMT_MJPEG) {
+    if (!jpeg.decode(raw.data, raw.bytes, mjpeg_scale, frame->MutablePixelData(),
+                     frame->Width(), frame->Height(), frame->WidthStep())) return nullptr;
+  } else {
+    return nullptr;
+  }
+  return frame;
+}
+
+// 그래프 출력(protobuf) -> POD 스냅샷. 콜백 스레드에서 한 번만 변환
+void ToSnapshot(const std::vector<NormalizedLandmarkList>& v, HandSnapshot& out) {
+  out.num_hands = 0;
+  for (const auto& lm : v) {
+    if (out.num_hands >= kMaxHands) break;
+    if (lm.landmark_size() < kNumLandmarks) continue;
+    HandLandmarks& h = out.hands[out.num_hands++];
+    for (int i = 0; i < kNumLandmarks; ++i) {
+      const auto& p = lm.landmark(i);
+      h.x[i] = p.x(); h.y[i] = p.y(); h.z[i] = p.z();
+    }
+    PadLandmarks(h);
   }
-  if (cnt == 0) return {-1.f, -1.f};
-  return {sx / cnt, sy / cnt};
 }
 
+// 마지막 손 검출 후 이 시간이 지나면 손 없음(0)으로 간주
+constexpr int64_t kFreshThreshUs = 300000; // 300ms
+
 int MapXTo255(float x_px, int width) {
   if (width <= 1) return 0;
   float v = (x_px / (float)(width - 1)) * 255.0f;
@@ -129,7 +170,105 @@ bool OpenCameraAuto(cv::VideoCapture& cap, int& out_w, int& out_h,
   return false;
 }
 
-static std::atomic<long long> g_last_obs_us{0};
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 캡처 스레드가 게시하는 한 프레임. 백엔드에 따라 둘 중 하나만 채워진다.
+struct CapturedFrame {
+  cv::Mat   bgr;          // cv::VideoCapture 경로 (처리 루프에서는 GUI 표시 버퍼로도 사용)
+  V4l2Frame raw;          // V4L2 mmap 경로 (드라이버 버퍼 직접 참조)
+  int64_t   capture_us = 0;
+};
+
+void SwapFrames(CapturedFrame& a, CapturedFrame& b) {
+  cv::swap(a.bgr, b.bgr);
+  std::swap(a.raw, b.raw);
+  std::swap(a.capture_us, b.capture_us);
+}
+
+// 캡처 스레드 -> 처리 루프 단일 슬롯 핸드오프.
+// 항상 최신 프레임만 유지하고, 소비되기 전에 덮어쓰인 프레임은 버린다(큐잉 없음).
+// 프레임을 swap 하므로 캡처/슬롯/처리 3개 버퍼가 돌아가며 재사용된다.
+class LatestFrameSlot {
+public:
+  // 캡처 스레드: 새 프레임 게시. frame 에는 이전 버퍼가 돌려진다.
+  void publish(CapturedFrame& frame) {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      if (has_) dropped_++;
+      SwapFrames(frame, cur_);
+      has_ = true;
+    }
+    cv_.notify_one();
+  }
+
+  // 처리 루프: 새 프레임을 기다려 가져감. timeout 또는 close() 시 false
+  bool take(CapturedFrame& out, int timeout_ms) {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (!cv_.wait_for(lk, std::chrono::milliseconds(timeout_ms),
+                      [&]{ return has_ || closed_; })) return false;
+    if (!has_) return false;
+    SwapFrames(out, cur_);
+    has_ = false;
+    return true;
+  }
+
+  void close() {
+    { std::lock_guard<std::mutex> lk(mu_); closed_ = true; }
+    cv_.notify_all();
+  }
+
+  uint64_t dropped() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return dropped_;
+  }
+
+private:
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  CapturedFrame cur_;
+  bool has_ = false;
+  bool closed_ = false;
+  uint64_t dropped_ = 0;
+};
+
+// 그래프 입력 admission control: 제출한 패킷 타임스탬프를 추적해서
+// 출력(또는 타임스탬프 바운드)이 돌아오기 전까지는 max_in_flight 이상 넣지 않는다.
+class InFlightTracker {
+public:
+  explicit InFlightTracker(int max_in_flight) : max_(std::max(1, max_in_flight)) {}
+
+  // 새 프레임을 넣어도 되는지. 완료 통지가 유실된 항목은 kLostUs 후 정리
+  bool can_admit(int64_t now_us) {
+    std::lock_guard<std::mutex> lk(mu_);
+    while (!ts_.empty() && now_us - ts_.front().second > kLostUs) ts_.pop_front();
+    return (int)ts_.size() < max_;
+  }
+
+  void submitted(int64_t pkt_us, int64_t now_us) {
+    std::lock_guard<std::mutex> lk(mu_);
+    ts_.emplace_back(pkt_us, now_us);
+  }
+
+  // 그래프가 pkt_us 까지 처리를 끝냄 (타임스탬프는 증가 순으로 제출됨)
+  void completed(int64_t pkt_us) {
+    std::lock_guard<std::mutex> lk(mu_);
+    while (!ts_.empty() && ts_.front().first <= pkt_us) ts_.pop_front();
+  }
+
+  int size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return (int)ts_.size();
+  }
+
+private:
+  static constexpr int64_t kLostUs = 1000000; // 1s
+  const int max_;
+  mutable std::mutex mu_;
+  std::deque<std::pair<int64_t, int64_t>> ts_; // (패킷 ts, 제출 시각)
+};
 
 } // namespace
 
@@ -139,6 +278,16 @@ HandTracker::HandTracker(int req_w, int req_h, int req_fps, bool gui,
   : req_w_(req_w), req_h_(req_h), req_fps_(req_fps), gui_(gui),
     on_value_(std::move(on_value)) {}
 
+void HandTracker::set_v4l2_device(const std::string& dev) { v4l2_dev_ = dev; }
+
+void HandTracker::set_max_in_flight(int n) { max_in_flight_ = std::max(1, n); }
+
+void HandTracker::set_emission(double max_hz, double min_hz, int change_threshold) {
+  emission_.max_hz = max_hz;
+  emission_.min_hz = min_hz;
+  emission_.change_threshold = change_threshold;
+}
+
 bool HandTracker::init(const std::string& graph_path) {
   (void)graph_path; // 실제 초기화는 run()에서 수행
   return true;
@@ -167,25 +316,57 @@ int HandTracker::run() {
 
   const std::vector<std::string> kCandidateStreams = {"multi_hand_landmarks","hand_landmarks","landmarks"};
   std::string landmarks_stream_used;
-  std::mutex latest_mu;
-  std::vector<NormalizedLandmarkList> latest_hands;
-  bool has_latest = false;
+  SeqlockSlot<HandSnapshot> latest_hands;   // 콜백 스레드가 유일한 writer
+  InFlightTracker inflight(max_in_flight_);
+  LatencyTrace& trace = LatencyTrace::instance();
+  EmissionScheduler emitter(emission_, on_value_);
+  int cam_w=0, cam_h=0;
+  int64_t last_hand_us = 0;   // 콜백 스레드 전용
+  HandFilterBank palm_filters(palm_filter_);   // 콜백 스레드 전용
 
   bool observe_ok = false;
   for (const auto& name : kCandidateStreams) {
+    // 타임스탬프 바운드도 관찰: 손이 없어 출력이 비는 프레임도 완료로 집계
     absl::Status obs = graph.ObserveOutputStream(
       name,
       [&](const Packet& p)->absl::Status {
-        const auto& v = p.Get<std::vector<NormalizedLandmarkList>>();
-        {
-          std::lock_guard<std::mutex> lk(latest_mu);
-          latest_hands = v; has_latest = true;
+        const int64_t ts = p.Timestamp().Value();
+        inflight.completed(ts);
+        trace.mark((uint64_t)ts, TraceStage::kLandmarks);
+        const int64_t now = NowUs();
+        int value = -1;
+        if (!p.IsEmpty()) {
+          HandSnapshot snap;
+          ToSnapshot(p.Get<std::vector<NormalizedLandmarkList>>(), snap);
+          snap.frame_ts_us = ts;
+          snap.obs_us = now;
+          if (snap.num_hands > 0) {
+            last_hand_us = now;
+            float px[kMaxHands], py[kMaxHands];
+            for (int i = 0; i < snap.num_hands; ++i) PalmCentroid(snap.hands[i], px[i], py[i]);
+            if (palm_filter_.enabled) {
+              // 외삽 목표: 캡처 시각 + 측정된 capture->send 지연 (+ 그 뒤 구간 추정치)
+              const int64_t horizon = trace.capture_to_send_p50() + palm_filter_.extra_latency_us;
+              palm_filters.update(px, py, snap.num_hands, ts, horizon, snap.palm_x, snap.palm_y);
+            } else {
+              std::copy(px, px + snap.num_hands, snap.palm_x);
+              std::copy(py, py + snap.num_hands, snap.palm_y);
+            }
+            value = MapXTo255(snap.palm_x[0] * cam_w, cam_w);
+          }
+          // GUI 도 송출 값과 같은 손바닥 위치를 그리도록 필터 결과까지 채워서 게시
+          latest_hands.store(snap);
+        }
+        // 손이 잠깐 안 잡힌 프레임은 무시, kFreshThreshUs 이상 없으면 0
+        if (value < 0 && now - last_hand_us > kFreshThreshUs) {
+          value = 0;
+          palm_filters.reset();
         }
-        auto tp = std::chrono::steady_clock::now();
-        long long us = std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
-        g_last_obs_us.store(us, std::memory_order_relaxed);
+        // 결과가 나온 즉시 송출 여부 결정 (캡처 루프 주기와 무관)
+        if (value >= 0) emitter.submit(value, (uint64_t)ts);
         return absl::OkStatus();
-      }
+      },
+      /*observe_timestamp_bounds=*/true
     );
     if (obs.ok()) { landmarks_stream_used = name; observe_ok = true; break; }
   }
@@ -194,9 +375,28 @@ int HandTracker::run() {
 
   const std::string kInput = "input_video";
 
+  // 카메라: V4L2 직접 백엔드 우선(설정 시), 실패하면 기존 CamTry 폴백 테이블
+  std::unique_ptr<V4l2Capture> v4l2;
   cv::VideoCapture cap;
-  int cam_w=0, cam_h=0;
-  if (!OpenCameraAuto(cap, cam_w, cam_h, req_w_, req_h_, req_fps_)) {
+  int mjpeg_scale = 8;
+  if (!v4l2_dev_.empty()) {
+    v4l2 = std::make_unique<V4l2Capture>(v4l2_dev_);
+    if (v4l2->open(req_w_, req_h_, req_fps_)) {
+      cam_w = v4l2->width(); cam_h = v4l2->height();
+      if (v4l2->fourcc() == V4L2_PIX_FMT_MJPEG) {
+        // 요청보다 큰 해상도로 협상되면 DCT 도메인에서 축소 디코딩
+        mjpeg_scale = MjpegScaleNum(cam_w, cam_h, req_w_, req_h_);
+        MjpegScaledSize(v4l2->width(), v4l2->height(), mjpeg_scale, cam_w, cam_h);
+        if (mjpeg_scale != 8)
+          std::cerr << "[CAM] MJPEG decode scale " << mjpeg_scale << "/8 -> "
+                    << cam_w << "x" << cam_h << "\n";
+      }
+    } else {
+      std::cerr << "[CAM] V4L2 backend unavailable, falling back to VideoCapture\n";
+      v4l2.reset();
+    }
+  }
+  if (!v4l2 && !OpenCameraAuto(cap, cam_w, cam_h, req_w_, req_h_, req_fps_)) {
     std::cerr << "Cannot open camera (all backends tried)\n"; return 1;
   }
 
@@ -204,6 +404,7 @@ int HandTracker::run() {
     absl::Status st = graph.StartRun({});
     if (!st.ok()) { std::cerr << st.message() << "\n"; return 1; }
   }
+  emitter.start();
 
   const char* kWinName = "Hand -> X(0~255)";
   if (gui_) { cv::namedWindow(kWinName, cv::WINDOW_NORMAL); cv::resizeWindow(kWinName, 1280, 1000); }
@@ -213,51 +414,112 @@ int HandTracker::run() {
   double fps_display = 0.0;
   auto last_frame_tp = std::chrono::steady_clock::now();
 
-  cv::Mat frame_bgr;
-  auto last_send_tp = std::chrono::steady_clock::now();
+  ImageFramePool pool(cam_w, cam_h);
+
+  // 캡처 전용 스레드: GUI/그래프 제출이 느려도 캡처 주기에 영향 없음
+  LatestFrameSlot slot;
+  std::atomic<bool> cap_running{true};
+  std::thread cap_thr([&]{
+    CapturedFrame buf;
+    while (cap_running.load(std::memory_order_relaxed)) {
+      if (v4l2) {
+        if (!v4l2->read(buf.raw, 100)) continue;
+        buf.capture_us = buf.raw.timestamp_us; // 커널 캡처 타임스탬프
+      } else {
+        if (!cap.read(buf.bgr) || buf.bgr.empty()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          continue;
+        }
+        buf.capture_us = NowUs();
+      }
+      slot.publish(buf);
+      buf.raw = V4l2Frame{}; // 밀려난 드라이버 버퍼 즉시 반환
+    }
+  });
+
+  MjpegDecoder jpeg;
+  HandSnapshot hands;
+  CapturedFrame cur;
+  cv::Mat& frame_bgr = cur.bgr;
+  int64_t last_pkt_us = 0;
 
   while (true) {
-    if (!cap.read(frame_bgr) || frame_bgr.empty()) { cv::waitKey(1); continue; }
-    if (frame_bgr.cols != cam_w || frame_bgr.rows != cam_h) {
-      cv::resize(frame_bgr, frame_bgr, cv::Size(cam_w, cam_h), 0, 0, cv::INTER_AREA);
+    if (!slot.take(cur, 100)) {
+      if (gui_ && cv::waitKey(1) == 27) break;
+      continue;
     }
 
+    // admission control: 그래프가 포화면 변환/제출 전에 버림 (지연 누적 방지)
+    if (!inflight.can_admit(NowUs())) {
+      admission_dropped_.fetch_add(1, std::memory_order_relaxed);
+      cur.raw = V4l2Frame{};
+      if (gui_ && cv::waitKey(1) == 27) break;
+      continue;
+    }
+
+    std::unique_ptr<ImageFrame> input_frame;
+    if (cur.raw.data) {
+      input_frame = V4l2FrameToImageFrameRGB(cur.raw, pool, jpeg, mjpeg_scale);
+      if (!input_frame) {
+        // 추적에 올리기 전에 버림 (kCapture 만 남은 고아 추적 방지). 로그는 1, 2, 4, 8... 번째만
+        uint64_t n = convert_failed_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if ((n & (n - 1)) == 0)
+          std::cerr << "[CAM] frame convert fail (" << n << " total): seq " << cur.raw.sequence
+                    << ", " << cur.raw.bytes << " bytes\n";
+        cur.raw = V4l2Frame{};
+        if (gui_ && cv::waitKey(1) == 27) break;
+        continue;
+      }
+      cur.raw = V4l2Frame{}; // 변환 끝난 드라이버 버퍼 반환
+      if (gui_) {
+        cv::Mat rgb(input_frame->Height(), input_frame->Width(), CV_8UC3,
+                    input_frame->MutablePixelData(), input_frame->WidthStep());
+        cv::cvtColor(rgb, frame_bgr, cv::COLOR_RGB2BGR);
+      }
+    } else {
+      if (frame_bgr.cols != cam_w || frame_bgr.rows != cam_h) {
+        cv::resize(frame_bgr, frame_bgr, cv::Size(cam_w, cam_h), 0, 0, cv::INTER_AREA);
+      }
+      input_frame = MatToImageFrameRGB(frame_bgr, pool);
+      if (!input_frame) { std::cerr << "[MP] frame alloc fail\n"; break; }
+    }
+
+    // 추적 ID = 패킷 타임스탬프 (캡처 시각, 단조 증가 보장). 변환에 성공한 프레임만 추적
+    int64_t pkt_us = std::max(cur.capture_us, last_pkt_us + 1);
+    last_pkt_us = pkt_us;
+    trace.mark((uint64_t)pkt_us, TraceStage::kCapture, cur.capture_us);
+
     auto nowtp = std::chrono::steady_clock::now();
     int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(nowtp.time_since_epoch()).count();
 
     // MediaPipe 제출
-    auto input_frame = MatToImageFrameRGB(frame_bgr);
-    Packet packet = mediapipe::Adopt(input_frame.release()).At(mediapipe::Timestamp(now_us));
+    Packet packet = mediapipe::Adopt(input_frame.release()).At(mediapipe::Timestamp(pkt_us));
+    inflight.submitted(pkt_us, now_us); // 제출 전에 기록 (완료 콜백이 먼저 올 수 있음)
     {
       absl::Status st = graph.AddPacketToInputStream(kInput, packet);
       if (!st.ok()) { std::cerr << "[MP] AddPacket fail: " << st.message() << "\n"; break; }
     }
+    trace.mark((uint64_t)pkt_us, TraceStage::kSubmit);
 
-    // 최신 결과 복사
-    std::vector<NormalizedLandmarkList> hands_copy;
-    {
-      std::lock_guard<std::mutex> lk(latest_mu);
-      if (has_latest) hands_copy = latest_hands;
-    }
+    // 최신 결과 스냅샷 (락/할당 없음)
+    bool has_hands = latest_hands.load(hands);
 
     // 신선도 체크
-    constexpr long long kFreshThreshUs = 300000; // 300ms
-    bool hands_fresh = (now_us - g_last_obs_us.load(std::memory_order_relaxed)) <= kFreshThreshUs;
-    bool hands_visible = hands_fresh && !hands_copy.empty();
+    bool hands_fresh = has_hands && (now_us - hands.obs_us) <= kFreshThreshUs;
+    bool hands_visible = hands_fresh && hands.num_hands > 0;
 
     int primary_x255 = -1;
 
     if (hands_visible) {
-      for (size_t i = 0; i < hands_copy.size(); ++i) {
-        const auto& lm = hands_copy[i];
-        auto palm = ComputePalmCenterPx(lm, frame_bgr.cols, frame_bgr.rows);
+      for (int i = 0; i < hands.num_hands; ++i) {
+        // 스냅샷의 손바닥 위치 = 실제 송출 값 (필터가 켜져 있으면 필터/외삽 결과)
+        const cv::Point2f palm(hands.palm_x[i] * cam_w, hands.palm_y[i] * cam_h);
+        int x255 = MapXTo255(palm.x, cam_w);
+        if (i == 0) primary_x255 = x255;
         if (palm.x >= 0 && palm.y >= 0) {
-          int x255 = MapXTo255(palm.x, frame_bgr.cols);
-          if (i == 0) primary_x255 = x255;
-
           if (gui_) {
             cv::circle(frame_bgr, palm, 8, cv::Scalar(0,255,0), -1);
-            char buf[64]; snprintf(buf, sizeof(buf), "hand%zu X255=%d", i, x255);
+            char buf[64]; snprintf(buf, sizeof(buf), "hand%d X255=%d", i, x255);
             cv::putText(frame_bgr, buf, palm + cv::Point2f(10,-10),
                         cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(0,255,0), 2);
           }
@@ -268,13 +530,6 @@ int HandTracker::run() {
       }
     }
 
-    // 15Hz 레이트로 콜백 호출(손 없으면 0)
-    if (std::chrono::duration<double>(nowtp - last_send_tp).count() >= (1.0/15.0)) {
-      last_send_tp = nowtp;
-      int value_to_send = (hands_visible && primary_x255 >= 0) ? primary_x255 : 0;
-      if (on_value_) on_value_(value_to_send);
-    }
-
     // FPS overlay
     double inst_dt = std::chrono::duration<double>(nowtp - last_frame_tp).count();
     last_frame_tp = nowtp;
@@ -283,11 +538,16 @@ int HandTracker::run() {
     else fps_display = 0.2 * inst_fps + 0.8 * fps_display;
 
     if (std::chrono::duration_cast<std::chrono::seconds>(nowtp - t0).count() >= 1) {
-      std::cerr << "[FPS] ~" << frames << " fps\n";
+      std::cerr << "[FPS] ~" << frames << " fps (cap dropped " << slot.dropped()
+                << ", busy dropped " << dropped_frames() << ", convert fail " << convert_failed()
+                << ", in-flight " << inflight.size()
+                << ", pool hit/miss " << pool.hits() << "/" << pool.misses()
+                << ", sent/skipped " << emitter.emitted() << "/" << emitter.suppressed() << ")\n";
       frames = 0; t0 = nowtp;
     } else {
       frames++;
     }
+    if (trace.take_dump_request()) trace.dump(std::cerr);
 
     if (gui_) {
       DrawFpsOverlay(frame_bgr, fps_display);
@@ -296,10 +556,16 @@ int HandTracker::run() {
       cv::imshow(kWinName, frame_bgr);
       int key = cv::waitKey(1);
       if (key == 27) break; // ESC
+      if (key == 'l') trace.request_dump();
     }
   }
 
+  cap_running.store(false);
+  slot.close();
+  cap_thr.join();
+
   graph.CloseInputStream("input_video");
   graph.WaitUntilDone();
+  emitter.stop();
   return 0;
 }
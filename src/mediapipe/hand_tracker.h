@@ -1,13 +1,36 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <string>
 
+#include "emission_scheduler.h"
+#include "palm_filter.h"
+
 class HandTracker {
 public:
-  // on_value: 15Hz로 호출, 손 없으면 0, 있으면 0~255
+  // on_value: 랜드마크 결과가 나올 때 EmissionScheduler 규칙에 따라 호출 (그래프 콜백/송출 스레드).
+  //           손 없으면 0, 있으면 0~255
   HandTracker(int req_w, int req_h, int req_fps, bool gui,
               std::function<void(int)> on_value);
 
+  // V4L2 mmap 캡처 백엔드 사용 (예: "/dev/video0"). 빈 문자열이면 cv::VideoCapture
+  void set_v4l2_device(const std::string& dev);
+
+  // 그래프에 동시에 들어가 있을 수 있는 최대 프레임 수 (기본 1).
+  // 포화 상태에서 들어온 프레임은 변환 전에 버린다.
+  void set_max_in_flight(int n);
+  // 그래프 포화로 버린 프레임 수
+  uint64_t dropped_frames() const { return admission_dropped_.load(std::memory_order_relaxed); }
+  // V4L2 원본 -> RGB 변환 실패로 버린 프레임 수 (손상 MJPEG, 해상도 불일치 등)
+  uint64_t convert_failed() const { return convert_failed_.load(std::memory_order_relaxed); }
+
+  // 값 송출 규칙: 최대/최소(keepalive) 빈도, 변화 임계값
+  void set_emission(double max_hz, double min_hz, int change_threshold);
+
+  // 손바닥 위치 필터 (One Euro + 선택적 지연 보상 외삽)
+  void set_palm_filter(const PalmFilterConfig& cfg) { palm_filter_ = cfg; }
+
   // graph 설정 파일 경로
   bool init(const std::string& graph_path);
   // 루프 실행(블로킹). ESC로 종료
@@ -17,4 +40,10 @@ private:
   int req_w_, req_h_, req_fps_;
   bool gui_;
   std::function<void(int)> on_value_;
+  std::string v4l2_dev_;
+  int max_in_flight_ = 1;
+  EmissionConfig emission_;
+  PalmFilterConfig palm_filter_;
+  std::atomic<uint64_t> admission_dropped_{0};
+  std::atomic<uint64_t> convert_failed_{0};
 };
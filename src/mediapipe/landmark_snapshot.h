@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 그래프 콜백 스레드(단일 writer) -> 처리 루프/기타 reader 로 최신 손 랜드마크 게시.
+// protobuf 객체 대신 고정 크기 POD 스냅샷을 seqlock 으로 주고받아 락/할당이 없다.
+
+constexpr int kNumLandmarks = 21;
+constexpr int kLandmarkPad = 24;   // SIMD 폭(4/8) 배수로 패딩, 패딩 칸은 손목(0) 값 복제
+constexpr int kMaxHands = 4;
+
+// 손 하나의 랜드마크 (structure-of-arrays, 정규화 좌표 0~1)
+struct alignas(32) HandLandmarks {
+  float x[kLandmarkPad];
+  float y[kLandmarkPad];
+  float z[kLandmarkPad];
+};
+
+struct HandSnapshot {
+  int64_t  frame_ts_us = 0;   // 그래프 패킷 타임스탬프 (= 추적 ID)
+  int64_t  obs_us = 0;        // 콜백 수신 시각 (steady_clock)
+  int      num_hands = 0;
+  // 손바닥 중심 (정규화). 필터가 켜져 있으면 필터/외삽 결과 = LED 로 송출되는 값
+  float    palm_x[kMaxHands] = {};
+  float    palm_y[kMaxHands] = {};
+  HandLandmarks hands[kMaxHands];
+};
+
+// 단일 writer / 다중 reader seqlock. reader 는 쓰기 중이면 재시도하며 일관된 복사본을 얻는다.
+template <class T>
+class SeqlockSlot {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqlockSlot needs a POD payload");
+
+public:
+  void store(const T& v) {
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);     // 홀수: 쓰는 중
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&val_, &v, sizeof(T));
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  // 한 번도 store 되지 않았으면 false
+  bool load(T& out) const {
+    uint32_t s1, s2;
+    do {
+      s1 = seq_.load(std::memory_order_acquire);
+      if (s1 & 1) continue;
+      std::memcpy(&out, &val_, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      s2 = seq_.load(std::memory_order_relaxed);
+      if (s1 == s2) return s1 != 0;
+    } while (true);
+  }
+
+  uint32_t version() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> seq_{0};
+  T val_{};
+};
@@ -0,0 +1,125 @@
+#include "latency_trace.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const char* const kStageNames[] = {"capture", "submit", "landmarks", "dispatch", "send", "ack"};
+
+thread_local uint64_t t_current_id = 0;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// ===== LatencyHistogram =====
+int LatencyHistogram::Index(uint64_t v) {
+  if (v < (1u << kSubBits)) return (int)v;
+  int e = 63 - __builtin_clzll(v);                 // floor(log2 v) >= kSubBits
+  int sub = (int)((v >> (e - kSubBits)) & ((1u << kSubBits) - 1));
+  int idx = ((e - kSubBits + 1) << kSubBits) + sub;
+  return idx < kBuckets ? idx : kBuckets - 1;
+}
+
+int64_t LatencyHistogram::UpperBound(int idx) {
+  if (idx < (1 << kSubBits)) return idx;
+  int e = (idx >> kSubBits) + kSubBits - 1;
+  int sub = idx & ((1 << kSubBits) - 1);
+  return (((int64_t)(1 << kSubBits) + sub + 1) << (e - kSubBits)) - 1;
+}
+
+void LatencyHistogram::add(int64_t us) {
+  if (us < 0) us = 0;
+  b_[Index((uint64_t)us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  int64_t m = max_.load(std::memory_order_relaxed);
+  while (us > m && !max_.compare_exchange_weak(m, us, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+  for (auto& b : b_) b.store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentile(double p) const {
+  uint64_t n = count();
+  if (n == 0) return 0;
+  uint64_t rank = (uint64_t)(p / 100.0 * (double)n + 0.5);
+  if (rank < 1) rank = 1;
+  uint64_t acc = 0;
+  for (int i = 0; i < kBuckets; ++i) {
+    acc += b_[i].load(std::memory_order_relaxed);
+    if (acc >= rank) return std::min(UpperBound(i), max());
+  }
+  return max();
+}
+
+// ===== LatencyTrace =====
+LatencyTrace& LatencyTrace::instance() {
+  static LatencyTrace t;
+  return t;
+}
+
+void LatencyTrace::set_current(uint64_t id) { t_current_id = id; }
+uint64_t LatencyTrace::current() { return t_current_id; }
+
+void LatencyTrace::mark(uint64_t id, TraceStage stage) { mark(id, stage, NowUs()); }
+
+void LatencyTrace::mark(uint64_t id, TraceStage stage, int64_t ts_us) {
+  if (id == 0) return;
+  const int st = (int)stage;
+  Slot& s = slots_[(id * 0x9E3779B97F4A7C15ull) >> 56];
+
+  if (stage == TraceStage::kCapture) {
+    // 새 프레임이 슬롯을 차지 (이전 프레임 추적은 종료)
+    for (auto& t : s.t) t.store(0, std::memory_order_relaxed);
+    s.t[st].store(ts_us, std::memory_order_relaxed);
+    s.id.store(id, std::memory_order_release);
+    return;
+  }
+  if (s.id.load(std::memory_order_acquire) != id) return;   // 이미 밀려난 프레임
+
+  int64_t expected = 0;
+  if (!s.t[st].compare_exchange_strong(expected, ts_us, std::memory_order_relaxed)) return;
+
+  for (int prev = st - 1; prev >= 0; --prev) {
+    int64_t tp = s.t[prev].load(std::memory_order_relaxed);
+    if (tp) { step_[st].add(ts_us - tp); break; }
+  }
+  int64_t t0 = s.t[(int)TraceStage::kCapture].load(std::memory_order_relaxed);
+  if (t0) total_[st].add(ts_us - t0);
+}
+
+void LatencyTrace::reset() {
+  for (auto& h : step_) h.reset();
+  for (auto& h : total_) h.reset();
+}
+
+int64_t LatencyTrace::capture_to_send_p50() const {
+  return total_[(int)TraceStage::kSend].percentile(50);
+}
+
+void LatencyTrace::dump(std::ostream& os) const {
+  char line[160];
+  std::snprintf(line, sizeof(line), "[TRACE] %-22s %8s %8s %8s %8s %8s\n",
+                "stage latency (us)", "n", "p50", "p95", "p99", "max");
+  os << line;
+  for (int st = 1; st < kStages; ++st) {
+    const LatencyHistogram* hs[2] = {&step_[st], &total_[st]};
+    const char* kind[2] = {"prev ->", "capture ->"};
+    for (int k = 0; k < 2; ++k) {
+      const auto& h = *hs[k];
+      std::snprintf(line, sizeof(line), "[TRACE] %-11s %-10s %8llu %8lld %8lld %8lld %8lld\n",
+                    kind[k], kStageNames[st], (unsigned long long)h.count(),
+                    (long long)h.percentile(50), (long long)h.percentile(95),
+                    (long long)h.percentile(99), (long long)h.max());
+      os << line;
+    }
+  }
+}
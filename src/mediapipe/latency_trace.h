@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// 프레임 단위 end-to-end 지연 추적 (캡처 -> 그래프 제출 -> 랜드마크 콜백
+// -> on_value_ 디스패치 -> 소켓 송신 -> 서버 LED_UPDATE 수신).
+// 추적 ID 는 그래프 패킷 타임스탬프(us)를 그대로 쓴다. 모든 스레드에서 lock-free 로 기록.
+enum class TraceStage : int {
+  kCapture = 0,
+  kSubmit,
+  kLandmarks,
+  kDispatch,
+  kSend,
+  kAck,      // 서버가 LED 반영을 알림 (NetClient 수신 경로)
+  kCount
+};
+
+// 로그-선형 버킷 히스토그램 (us 단위, 상대 오차 ~12%)
+class LatencyHistogram {
+public:
+  void add(int64_t us);
+  void reset();
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  int64_t  max() const   { return max_.load(std::memory_order_relaxed); }
+  int64_t  percentile(double p) const;   // 0~100
+
+private:
+  static constexpr int kSubBits = 3;
+  static constexpr int kBuckets = (40 - kSubBits + 1) << kSubBits;
+  static int     Index(uint64_t v);
+  static int64_t UpperBound(int idx);
+
+  std::atomic<uint64_t> b_[kBuckets]{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t>  max_{0};
+};
+
+class LatencyTrace {
+public:
+  static LatencyTrace& instance();
+
+  // id 프레임이 stage 에 도달한 시각 기록 (같은 단계는 처음 한 번만 집계)
+  void mark(uint64_t id, TraceStage stage, int64_t ts_us);
+  void mark(uint64_t id, TraceStage stage);
+
+  // on_value_ 콜백 경계를 넘어 추적 ID 전달 (디스패치 스레드 로컬)
+  static void     set_current(uint64_t id);
+  static uint64_t current();
+
+  // 단계별 p50/p95/p99/max (직전 단계 대비, 캡처 대비) 출력
+  void dump(std::ostream& os) const;
+  void reset();
+
+  // 시그널 핸들러에서 호출 가능 (플래그만 설정)
+  void request_dump() { dump_req_.store(true, std::memory_order_relaxed); }
+  bool take_dump_request() { return dump_req_.exchange(false, std::memory_order_relaxed); }
+
+  // 캡처 -> 송신 최근 p50 (예측 필터 등에서 사용)
+  int64_t capture_to_send_p50() const;
+
+private:
+  LatencyTrace() = default;
+
+  static constexpr int kSlots = 256;
+  static constexpr int kStages = (int)TraceStage::kCount;
+  struct Slot {
+    std::atomic<uint64_t> id{0};
+    std::atomic<int64_t>  t[kStages]{};
+  };
+
+  Slot slots_[kSlots];
+  LatencyHistogram step_[kStages];   // 직전에 기록된 단계 -> 이 단계
+  LatencyHistogram total_[kStages];  // 캡처 -> 이 단계
+  std::atomic<bool> dump_req_{false};
+};
@@ -0,0 +1,86 @@
+// latency_trace 벤치마크: 지연 추적이 프레임마다 더하는 비용 (ns, 배치 중앙값)
+//   histogram add : LatencyHistogram::add 한 번
+//   mark          : 시각을 넘기는 mark 한 번 (kCapture 제외 단계)
+//   frame         : 한 프레임의 전체 단계 mark (kCapture .. kAck, 시각 직접 전달)
+//   frame + clock : 같은 순서를 steady_clock 으로 찍는 mark(id, stage)
+//
+//   ./latency_trace_bench [--batches=N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "latency_trace.h"
+
+namespace {
+
+constexpr int kBatch = 10000;
+int g_batches = 50;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <class F>
+double MedianNs(F&& fn) {
+  std::vector<double> t(g_batches);
+  for (int i = 0; i < kBatch; ++i) fn();
+  for (int b = 0; b < g_batches; ++b) {
+    const int64_t t0 = NowNs();
+    for (int i = 0; i < kBatch; ++i) fn();
+    t[b] = (double)(NowNs() - t0) / kBatch;
+  }
+  std::nth_element(t.begin(), t.begin() + g_batches / 2, t.end());
+  return t[g_batches / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--batches=", 10) == 0) {
+      g_batches = std::max(1, std::atoi(argv[i] + 10));
+    } else {
+      std::fprintf(stderr, "usage: %s [--batches=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  LatencyHistogram hist;
+  int64_t v = 0;
+  std::printf("histogram add       %6.1f ns\n",
+              MedianNs([&] { hist.add(v); v = (v + 37) & 0xfffff; }));
+
+  LatencyTrace& tr = LatencyTrace::instance();
+  constexpr int kStages = (int)TraceStage::kCount;
+
+  // 프레임 ID 는 실제처럼 33 ms 간격 패킷 타임스탬프
+  uint64_t id = 1000000;
+  int64_t ts = 0;
+  tr.mark(id, TraceStage::kCapture, ts);
+  int stage = 1;
+  std::printf("mark                %6.1f ns\n", MedianNs([&] {
+                if (stage == kStages) {
+                  id += 33333;
+                  tr.mark(id, TraceStage::kCapture, ts);
+                  stage = 1;
+                }
+                ts += 1000;
+                tr.mark(id, (TraceStage)stage++, ts);
+              }));
+
+  std::printf("frame (%d marks)     %6.1f ns\n", kStages, MedianNs([&] {
+                id += 33333;
+                for (int s = 0; s < kStages; ++s) tr.mark(id, (TraceStage)s, ts += 1000);
+              }));
+  std::printf("frame + clock       %6.1f ns\n", MedianNs([&] {
+                id += 33333;
+                for (int s = 0; s < kStages; ++s) tr.mark(id, (TraceStage)s);
+              }));
+  return 0;
+}
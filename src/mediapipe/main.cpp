@@ -1,8 +1,13 @@
 #include "hand_tracker.h"
 #include "net_client.h"
+#include "latency_trace.h"
+#include <csignal>
 #include <cstdlib>
 #include <iostream>
 
+// kill -USR1 <pid> 로 단계별 지연 히스토그램 출력
+static void OnSigUsr1(int) { LatencyTrace::instance().request_dump(); }
+
 int main(int argc, char** argv) {
   // 서버 설정 (기존 상수와 동일)
   const char* kSrvIp = "10.10.16.243";
@@ -11,21 +16,49 @@ int main(int argc, char** argv) {
   const char* kMyPw  = "PASSWD";
 
   bool gui = true;
+  bool binary = false;
+  bool udp = false;
+  std::string v4l2_dev;
+  int max_in_flight = 1;
+  EmissionConfig emit_cfg;
+  PalmFilterConfig filter_cfg;
   for (int i=1;i<argc;i++) {
     std::string a = argv[i];
     if (a == "--no-gui") gui = false;
     if (a == "--gui")    gui = true;
+    if (a == "--bin")    binary = true;
+    if (a == "--udp")    udp = true;
+    if (a == "--v4l2")   v4l2_dev = "/dev/video0";
+    if (a.rfind("--v4l2=", 0) == 0) v4l2_dev = a.substr(7);
+    if (a.rfind("--max-inflight=", 0) == 0) max_in_flight = std::atoi(a.c_str() + 15);
+    if (a.rfind("--emit-max-hz=", 0) == 0)   emit_cfg.max_hz = std::atof(a.c_str() + 14);
+    if (a.rfind("--emit-min-hz=", 0) == 0)   emit_cfg.min_hz = std::atof(a.c_str() + 14);
+    if (a.rfind("--emit-threshold=", 0) == 0) emit_cfg.change_threshold = std::atoi(a.c_str() + 17);
+    if (a == "--no-filter") filter_cfg.enabled = false;
+    if (a == "--predict")   filter_cfg.predict = true;
+    if (a.rfind("--filter-mincutoff=", 0) == 0) filter_cfg.min_cutoff = std::atof(a.c_str() + 19);
+    if (a.rfind("--filter-beta=", 0) == 0)      filter_cfg.beta = std::atof(a.c_str() + 14);
+    if (a.rfind("--predict-extra-ms=", 0) == 0) filter_cfg.extra_latency_us = std::atoi(a.c_str() + 19) * 1000LL;
   }
 
+  std::signal(SIGUSR1, OnSigUsr1);
+
   // 네트워킹 시작
   NetClient net(kSrvIp, kSrvPort, kMyId, kMyPw, "2");
+  net.set_binary(binary);
+  net.set_udp(udp);
   net.start();
 
-  // HandTracker: 640x480@30, 15Hz로 net.send_value 호출 (손 없으면 0)
+  // HandTracker: 640x480@30, 랜드마크가 나올 때마다 규칙에 따라 net.send_value 호출 (손 없으면 0)
   HandTracker tracker(640, 480, 30, gui, [&](int v){
     net.send_value(v);
   });
 
+  tracker.set_v4l2_device(v4l2_dev);
+  tracker.set_max_in_flight(max_in_flight);
+  tracker.set_emission(emit_cfg.max_hz, emit_cfg.min_hz, emit_cfg.change_threshold);
+  tracker.set_palm_filter(filter_cfg);
+
   if (!tracker.init("mediapipe/graphs/hand_tracking/hand_tracking_desktop_live.pbtxt")) {
     std::cerr << "tracker init failed\n";
     return 1;
@@ -34,5 +67,6 @@ int main(int argc, char** argv) {
   int ret = tracker.run();
 
   net.stop();
+  LatencyTrace::instance().dump(std::cerr);
   return ret;
 }
@@ -1,31 +1,52 @@
 #include "net_client.h"
+#include "led_frame.h"      // rsp_server/led_frame.h (서버와 같은 헤더)
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
 
 // POSIX
 #include <unistd.h>
+#include <poll.h>
 #include <arpa/inet.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <netinet/in.h>
 
+namespace {
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr int64_t kRttLogIntervalUs = 5000000;
+} // namespace
+
 NetClient::NetClient(std::string server_ip, int server_port,
                      std::string my_id, std::string my_pw,
                      std::string to_id)
   : ip_(std::move(server_ip)), port_(server_port),
     my_id_(std::move(my_id)), my_pw_(std::move(my_pw)),
-    to_id_(std::move(to_id)) {}
+    to_id_(std::move(to_id)) {
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
 
-NetClient::~NetClient() { stop(); }
+NetClient::~NetClient() {
+  stop();
+  if (wake_fd_ >= 0) ::close(wake_fd_);
+}
 
 void NetClient::start() {
   if (running_.exchange(true)) return;
-  thr_ = std::thread(&NetClient::sender_thread_, this);
+  thr_ = std::thread(&NetClient::io_thread_, this);
 }
 
 void NetClient::stop() {
   if (!running_.exchange(false)) return;
-  cv_.notify_all();
+  wake_();
   if (thr_.joinable()) thr_.join();
 }
 
@@ -33,30 +54,44 @@ void NetClient::send_value(int value) {
   if (value < 0) value = 0;
   if (value > 255) value = 255;
 
-  // 항상 LED@ + 2자리 대문자 HEX (00~FF)
-  std::ostringstream oss;
-  oss << "LED@0x" << std::hex
-      << std::setw(2) << std::setfill('0') << value;
+  // 포맷/할당/락 없이 슬롯만 교체. 이전 값이 남아 있었으면 덮어쓴 것
+  uint64_t prev = latest_.exchange(pack_(value, LatencyTrace::current()), std::memory_order_acq_rel);
+  if (prev != 0) coalesced_.fetch_add(1, std::memory_order_relaxed);
+  wake_();
+}
+
+void NetClient::send_message(std::string payload) {
+  push_(std::move(payload), LatencyTrace::current());
+}
 
-  push_(oss.str());
+void NetClient::push_(std::string s, uint64_t trace_id) {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (q_.size() > 200) q_.pop_front();
+    q_.push_back(Item{std::move(s), trace_id});
+  }
+  wake_();
 }
 
-void NetClient::push_(std::string s) {
+void NetClient::push_front_(Item item) {
   std::lock_guard<std::mutex> lk(mu_);
-  if (q_.size() > 200) q_.pop_front();
-  q_.push_back(std::move(s));
-  cv_.notify_one();
+  q_.push_front(std::move(item));
 }
 
-bool NetClient::pop_wait_(std::string& out) {
-  std::unique_lock<std::mutex> lk(mu_);
-  cv_.wait(lk, [&]{ return !q_.empty() || !running_.load(); });
-  if (!running_.load() && q_.empty()) return false;
+bool NetClient::pop_(Item& out) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (q_.empty()) return false;
   out = std::move(q_.front());
   q_.pop_front();
   return true;
 }
 
+void NetClient::wake_() {
+  uint64_t one = 1;
+  ssize_t r = ::write(wake_fd_, &one, sizeof(one));
+  (void)r;   // 카운터 포화(EAGAIN)여도 이미 깨어날 상태
+}
+
 int NetClient::connect_and_auth_() {
   int sock = ::socket(AF_INET, SOCK_STREAM, 0);
   if (sock < 0) return -1;
@@ -69,45 +104,307 @@ int NetClient::connect_and_auth_() {
   if (::connect(sock, (sockaddr*)&addr, sizeof(addr)) < 0) {
     ::close(sock); return -1;
   }
-  // 서버는 "id:pw" (개행 없이) 기대
+  // 로그인 "id:pw\n". 바이너리 요청 시 ":BIN1" 을 붙인다. 개행이 있어야 서버가 로그인 끝을
+  // 알 수 있어, 곧바로 이어 보낸 "<id>:..." 명령이 로그인에 섞이지 않는다
   std::string auth = my_id_ + ":" + my_pw_;
+  if (binary_) auth += std::string(":") + LED_PROTO_BIN_TAG;
+  auth += '\n';
   ssize_t n = ::send(sock, auth.c_str(), (int)auth.size(), 0);
   if (n != (ssize_t)auth.size()) { ::close(sock); return -1; }
+
+  bin_active_ = false;
+  if (binary_) {
+    // 응답 "[SERVER]Connected BIN1" 을 확인해야 프레임 전송 (구 서버는 텍스트 유지)
+    timeval tv{1, 0};
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    // 응답 줄만 읽음 (뒤따르는 상태 스냅샷 프레임은 수신 루프가 처리)
+    char reply[128];
+    ssize_t r = ::recv(sock, reply, sizeof(reply) - 1, MSG_PEEK);
+    if (r > 0) {
+      const char* nl = (const char*)std::memchr(reply, '\n', (size_t)r);
+      if (nl) r = (ssize_t)(nl - reply) + 1;
+      r = ::recv(sock, reply, (size_t)r, 0);
+    }
+    if (r > 0) {
+      reply[r] = '\0';
+      bin_active_ = std::strstr(reply, LED_PROTO_BIN_TAG) != nullptr;
+      if (bin_active_ && udp_) open_udp_(reply);
+    }
+    tv = timeval{0, 0};
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (!bin_active_) std::cerr << "[NET] server did not accept binary frames, using text\n";
+  }
   return sock;
 }
 
-void NetClient::sender_thread_() {
+void NetClient::open_udp_(const char* reply) {
+  // "[SERVER]Connected BIN1 UDP@xxxxxxxx"
+  const char* tag = std::strstr(reply, LED_UDP_TAG);
+  unsigned token = 0;
+  if (!tag || std::sscanf(tag + std::strlen(LED_UDP_TAG), "%8x", &token) != 1 || token == 0) {
+    std::cerr << "[NET] server did not issue a UDP token, LED values stay on TCP\n";
+    return;
+  }
+  int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return;
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port   = htons(port_);
+  if (::inet_pton(AF_INET, ip_.c_str(), &addr.sin_addr) != 1 ||
+      ::connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    ::close(fd); return;
+  }
+  udp_fd_ = fd;
+  udp_token_ = token;
+}
+
+void NetClient::close_conn_(int& sock) {
+  if (sock >= 0) ::close(sock);
+  sock = -1;
+  if (udp_fd_ >= 0) ::close(udp_fd_);
+  udp_fd_ = -1;
+  udp_token_ = 0;
+}
+
+bool NetClient::send_led_(int sock, uint64_t slot) {
+  const uint8_t value = (uint8_t)(slot & 0xFF);
+  const uint64_t trace_id = slot >> 16;
+  const int64_t now = NowUs();
+  uint8_t buf[64];
+  size_t len;
+  int fd = sock;
+
+  Pending& p = pending_[pending_head_];
+  if (p.send_us) unacked_.fetch_add(1, std::memory_order_relaxed);   // ack 없이 밀려남
+  pending_head_ = (pending_head_ + 1) % kPending;
+
+  if (bin_active_) {
+    // 바이너리 프레임 (UDP 면 앞에 토큰). ts_us 는 송신 시각이며 LED_UPDATE 가 그대로 되돌려준다
+    led_frame f{};
+    f.type = LED_FRAME_SET;
+    f.value = value;
+    f.seq = ++seq_;
+    f.ts_us = (uint64_t)now;
+    size_t off = 0;
+    if (udp_fd_ >= 0) {
+      buf[0] = (uint8_t)(udp_token_ >> 24); buf[1] = (uint8_t)(udp_token_ >> 16);
+      buf[2] = (uint8_t)(udp_token_ >> 8);  buf[3] = (uint8_t)udp_token_;
+      off = 4;
+      fd = udp_fd_;
+    }
+    led_frame_encode(&f, buf + off);
+    len = off + LED_FRAME_SIZE;
+    p = Pending{now, trace_id, f.seq, value, true};
+  } else {
+    // "2:LED@0xNN\n" 스택 버퍼에 바로 포맷 (항상 LED@ + 2자리 HEX)
+    int n = std::snprintf((char*)buf, sizeof(buf), "%s:LED@0x%02x\n", to_id_.c_str(), (int)value);
+    len = (size_t)std::min(n, (int)sizeof(buf) - 1);
+    p = Pending{now, trace_id, 0, value, false};
+  }
+
+  ssize_t n = ::send(fd, buf, len, MSG_NOSIGNAL);
+  if (n == (ssize_t)len) {
+    LatencyTrace::instance().mark(trace_id, TraceStage::kSend);
+    return true;
+  }
+  p.send_us = 0;
+  // UDP 실패는 재전송 없이 다음 값이 대체
+  return fd != sock;
+}
+
+bool NetClient::flush_(int sock) {
+  // "2:<메시지>\n" 로 전송 (순서 유지)
+  Item item;
+  while (pop_(item)) {
+    std::string wire = to_id_ + ":" + item.payload;
+    if (wire.back() != '\n') wire.push_back('\n');
+    ssize_t n = ::send(sock, wire.c_str(), wire.size(), MSG_NOSIGNAL);
+    if (n != (ssize_t)wire.size()) {
+      push_front_(std::move(item));
+      return false;
+    }
+    LatencyTrace::instance().mark(item.trace_id, TraceStage::kSend);
+  }
+
+  // SLOWDOWN 이후에는 간격이 지나야 꺼냄 (그동안 들어온 값은 슬롯에서 최신 하나로 합쳐짐)
+  const int64_t now = NowUs();
+  if (led_interval_us_ && now < next_led_us_) return true;
+  uint64_t slot = latest_.exchange(0, std::memory_order_acq_rel);
+  if (slot != 0) next_led_us_ = now + led_interval_us_;
+  if (slot != 0 && !send_led_(sock, slot)) {
+    // 실패한 LED 값은 더 새 값이 없을 때만 되돌려 재접속 후 전송
+    uint64_t expected = 0;
+    latest_.compare_exchange_strong(expected, slot, std::memory_order_acq_rel);
+    return false;
+  }
+  return true;
+}
+
+bool NetClient::read_inbound_(int sock) {
+  // 한 번 깨어날 때 읽는 양을 제한해 수신 폭주 중에도 송신이 굶지 않게 한다
+  for (int rounds = 0; rounds < 4; ++rounds) {
+    if (rx_len_ == sizeof(rx_buf_)) rx_len_ = 0;   // 개행 없는 긴 텍스트는 버림
+    ssize_t r = ::recv(sock, rx_buf_ + rx_len_, sizeof(rx_buf_) - rx_len_, MSG_DONTWAIT);
+    if (r == 0) return false;
+    if (r < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      if (errno == EINTR) continue;
+      return false;
+    }
+    rx_len_ += (size_t)r;
+    parse_inbound_();
+  }
+  return true;
+}
+
+void NetClient::parse_inbound_() {
+  // 0xA5 로 시작하면 16바이트 프레임, 아니면 "\n" 까지 텍스트 한 줄
+  size_t pos = 0;
+  while (pos < rx_len_) {
+    led_frame f;
+    int r = led_frame_decode(rx_buf_ + pos, rx_len_ - pos, &f);
+    if (r == 0) break;
+    if (r > 0) {
+      // 로그인 스냅샷(LED_FLAG_SNAPSHOT)은 내 명령에 대한 응답이 아니므로 매칭하지 않음
+      if (f.type == LED_FRAME_UPDATE && !(f.flags & LED_FLAG_SNAPSHOT))
+        on_led_update_(true, f.value, f.seq, f.ts_us);
+      pos += (size_t)r;
+      continue;
+    }
+    uint8_t* nl = (uint8_t*)std::memchr(rx_buf_ + pos, '\n', rx_len_ - pos);
+    if (!nl) break;
+    const char* line = (const char*)rx_buf_ + pos;
+    const size_t line_len = (size_t)(nl - (rx_buf_ + pos));
+    // 텍스트 스냅샷은 "[SERVER]LED_STATE@" 라 여기 걸리지 않음
+    static constexpr char kUpdate[] = "[SERVER]LED_UPDATE@0x";
+    static constexpr char kSlowdown[] = "[SERVER]SLOWDOWN@";
+    if (line_len > sizeof(kUpdate) - 1 && std::memcmp(line, kUpdate, sizeof(kUpdate) - 1) == 0) {
+      unsigned v = 0;
+      if (std::sscanf(line + sizeof(kUpdate) - 1, "%2x", &v) == 1)
+        on_led_update_(false, (uint8_t)v, 0, 0);
+    } else if (line_len > sizeof(kSlowdown) - 1 &&
+               std::memcmp(line, kSlowdown, sizeof(kSlowdown) - 1) == 0) {
+      int hz = 0;
+      if (std::sscanf(line + sizeof(kSlowdown) - 1, "%d", &hz) == 1) on_slowdown_(hz);
+    }
+    pos = (size_t)(nl - rx_buf_) + 1;
+  }
+  if (pos) {
+    std::memmove(rx_buf_, rx_buf_ + pos, rx_len_ - pos);
+    rx_len_ -= pos;
+  }
+}
+
+void NetClient::on_led_update_(bool binary, uint8_t value, uint16_t seq, uint64_t ts_us) {
+  // 바이너리: 되돌아온 seq/ts 가 내가 보낸 프레임과 같아야 함 (다른 클라이언트 명령 제외)
+  // 텍스트: 값이 같은 가장 오래된 미확인 명령 (다른 클라이언트가 같은 값을 보내면 오차 가능)
+  int match = -1;
+  for (int k = 0; k < kPending; ++k) {
+    int i = (pending_head_ + k) % kPending;   // 오래된 것부터
+    const Pending& p = pending_[i];
+    if (!p.send_us || p.binary != binary) continue;
+    if (binary ? (p.seq == seq && (uint64_t)p.send_us == ts_us) : p.value == value) {
+      match = i;
+      break;
+    }
+  }
+  if (match < 0) return;
+
+  const int64_t now = NowUs();
+  rtt_.add(now - pending_[match].send_us);
+  LatencyTrace::instance().mark(pending_[match].trace_id, TraceStage::kAck, now);
+  // 더 오래된 미확인 명령은 ack 를 못 받은 것
+  for (int i = match;; ) {
+    if (i != match && pending_[i].send_us) unacked_.fetch_add(1, std::memory_order_relaxed);
+    pending_[i].send_us = 0;
+    if (i == pending_head_) break;
+    i = (i + kPending - 1) % kPending;
+  }
+}
+
+void NetClient::on_slowdown_(int hz) {
+  // 서버 속도 제한에 걸림: LED 값은 그 빈도 이하로만 보내고 사이 값은 최신값 슬롯에서 합쳐진다
+  // (서버 제한보다 조금 낮춰 토큰이 남게 함). 0 이면 해제
+  const int64_t interval = hz > 0 ? 1000000 / hz + 1000000 / hz / 10 : 0;
+  if (interval == led_interval_us_) return;
+  led_interval_us_ = interval;
+  led_max_hz_.store(hz, std::memory_order_relaxed);
+  std::cerr << "[NET] server asked to slow down, LED values max " << hz << " Hz\n";
+}
+
+void NetClient::expire_pending_(int64_t now) {
+  for (auto& p : pending_) {
+    if (p.send_us && now - p.send_us > kAckTimeoutUs) {
+      p.send_us = 0;
+      unacked_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void NetClient::log_rtt_(int64_t now) {
+  if (now - last_rtt_log_us_ < kRttLogIntervalUs) return;
+  last_rtt_log_us_ = now;
+  if (rtt_.count() == last_rtt_count_) return;
+  last_rtt_count_ = rtt_.count();
+  std::cout << "[NET] rtt(us) p50=" << rtt_.percentile(50) << " p95=" << rtt_.percentile(95)
+            << " p99=" << rtt_.percentile(99) << " max=" << rtt_.max()
+            << " acked=" << rtt_.count() << " unacked=" << unacked() << std::endl;
+}
+
+void NetClient::io_thread_() {
   int sock = -1;
   int backoff_ms = 200;
+  int64_t retry_at_us = 0;
+  uint64_t drained;
 
   while (running_.load()) {
-    if (sock < 0) {
+    const int64_t now = NowUs();
+    if (sock < 0 && now >= retry_at_us) {
       sock = connect_and_auth_();
       if (sock >= 0) {
-        std::cerr << "[NET] connected & authed\n";
+        std::cerr << "[NET] connected & authed" << (udp_fd_ >= 0 ? " (udp)" : "") << "\n";
         backoff_ms = 200;
+        rx_len_ = 0;
+        for (auto& p : pending_) p.send_us = 0;
+        led_interval_us_ = 0;
+        led_max_hz_.store(0, std::memory_order_relaxed);
       } else {
-        std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+        retry_at_us = now + backoff_ms * 1000LL;
         backoff_ms = std::min(backoff_ms * 2, 3000);
-        continue;
       }
     }
 
-    std::string payload;
-    if (!pop_wait_(payload)) break;
-
-    // "2:<숫자>\n" 로 전송
-    std::string wire = to_id_ + ":" + payload;
-    if (wire.empty() || wire.back() != '\n') wire.push_back('\n');
+    // 깨움(eventfd) 또는 서버 수신을 기다림. 재접속 대기 중에는 값이 슬롯에 모이기만 한다
+    pollfd fds[2] = {{wake_fd_, POLLIN, 0}, {sock, POLLIN, 0}};
+    int timeout_ms = 1000;
+    if (sock < 0) timeout_ms = (int)std::max<int64_t>(0, (retry_at_us - now + 999) / 1000);
+    // 속도 제한으로 미룬 LED 값이 있으면 송신 가능 시각에 깨어남
+    else if (led_interval_us_ && latest_.load(std::memory_order_relaxed) != 0)
+      timeout_ms = (int)std::max<int64_t>(0, (next_led_us_ - now + 999) / 1000);
+    int pr = ::poll(fds, sock >= 0 ? 2 : 1, timeout_ms);
+    if (pr < 0 && errno != EINTR) break;
+    if (fds[0].revents & POLLIN) {
+      ssize_t r = ::read(wake_fd_, &drained, sizeof(drained));
+      (void)r;
+    }
+    if (!running_.load()) break;
+    if (sock < 0) continue;
 
-    ssize_t n = ::send(sock, wire.c_str(), (int)wire.size(), 0);
-    if (n != (ssize_t)wire.size()) {
+    if ((fds[1].revents & (POLLIN | POLLHUP | POLLERR)) && !read_inbound_(sock)) {
+      std::cerr << "[NET] server closed connection, reconnecting...\n";
+      close_conn_(sock);
+      continue;
+    }
+    if (!flush_(sock)) {
       std::cerr << "[NET] send fail, reconnecting...\n";
-      ::close(sock);
-      sock = -1;
+      close_conn_(sock);
+      continue;
     }
+    const int64_t t = NowUs();
+    expire_pending_(t);
+    log_rtt_(t);
   }
 
-  if (sock >= 0) ::close(sock);
-  std::cerr << "[NET] sender thread exit\n";
+  close_conn_(sock);
+  std::cerr << "[NET] io thread exit (coalesced " << coalesced() << ", unacked " << unacked() << ")\n";
 }
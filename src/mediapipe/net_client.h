@@ -2,11 +2,11 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <cstdint>
 #include <deque>
 #include <mutex>
-#include <condition_variable>
-#include <iomanip>
-#include <sstream>
+
+#include "latency_trace.h"
 
 class NetClient {
 public:
@@ -15,20 +15,78 @@ public:
             std::string to_id = "KSH_QT");
   ~NetClient();
 
+  // 바이너리 LED 프레임 사용 (start() 전에 설정). 로그인 시 협상하며 서버가 거절하면 텍스트로 동작
+  void set_binary(bool on) { binary_ = on; }
+  // LED 값을 UDP 데이터그램으로 전송 (바이너리 프레임 전제, 인증/채팅은 TCP).
+  // 손실된 값은 재전송하지 않고 다음 값으로 대체되며, TCP 헤드오브라인 블로킹을 피한다.
+  void set_udp(bool on) { udp_ = on; if (on) binary_ = true; }
+
   void start();
   void stop();
 
-  // 숫자 전송 요청(내부 큐에 적재; 실제 송신은 전송 스레드가 수행)
+  // 숫자 전송 요청. 최신값 슬롯(atomic)에 덮어쓰고 I/O 스레드를 깨운다.
+  // 아직 송신되지 않은 이전 값은 버려지며(coalesce), 재접속 후에도 최신값 하나만 나간다.
+  // 호출 스레드의 LatencyTrace::current() 추적 ID 가 함께 저장되어 송신/ack 시각이 기록된다.
   void send_value(int value); // 0~255
 
+  // 순서가 중요한 일반 메시지(채팅 등)는 기존 큐로 전송 (최대 200개)
+  void send_message(std::string payload);
+
+  // 송신 전에 새 값으로 덮여 버려진 값 수
+  uint64_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+  // LED 명령 송신 -> 서버 LED_UPDATE 수신 왕복 지연 (us)
+  const LatencyHistogram& rtt() const { return rtt_; }
+  // ack 없이 밀려난 LED 명령 수 (손실 또는 서버가 알림을 생략)
+  uint64_t unacked() const { return unacked_.load(std::memory_order_relaxed); }
+  // 서버 "[SERVER]SLOWDOWN@<hz>" 로 낮춘 LED 송신 빈도 (0 = 제한 없음)
+  int led_max_hz() const { return led_max_hz_.load(std::memory_order_relaxed); }
+
 private:
+  struct Item {
+    std::string payload;
+    uint64_t    trace_id = 0;
+  };
+
+  // ack 대기 중인 LED 명령 (I/O 스레드 전용 링)
+  struct Pending {
+    int64_t  send_us = 0;      // 0 = 빈 칸
+    uint64_t trace_id = 0;
+    uint16_t seq = 0;
+    uint8_t  value = 0;
+    bool     binary = false;
+  };
+  static constexpr int kPending = 32;
+  static constexpr int64_t kAckTimeoutUs = 2000000;
+
+  // 최신값 슬롯: [trace_id(48) | valid(1) | value(8)], 0 이면 비어 있음
+  static constexpr uint64_t kSlotValid = 1ull << 8;
+  static uint64_t pack_(int value, uint64_t trace_id) {
+    return (trace_id << 16) | kSlotValid | (uint64_t)(value & 0xFF);
+  }
+
   // queue
-  void push_(std::string s);
-  bool pop_wait_(std::string& out);
+  void push_(std::string s, uint64_t trace_id = 0);
+  void push_front_(Item item);   // 전송 못한 메시지를 순서 유지한 채 되돌림
+  bool pop_(Item& out);
+  void wake_();
 
   // thread routine
-  void sender_thread_();
+  void io_thread_();
   int  connect_and_auth_();
+  void open_udp_(const char* reply);
+  void close_conn_(int& sock);
+  // 큐 메시지 -> 최신 LED 값 순으로 송신. 소켓 오류면 false
+  bool flush_(int sock);
+  bool send_led_(int sock, uint64_t slot);
+
+  // 수신: 서버 트래픽을 계속 비워 서버 write 가 막히지 않게 하고 LED_UPDATE 로 RTT 측정
+  bool read_inbound_(int sock);   // 연결 끊김이면 false
+  void parse_inbound_();
+  void on_led_update_(bool binary, uint8_t value, uint16_t seq, uint64_t ts_us);
+  void on_slowdown_(int hz);
+  void expire_pending_(int64_t now);
+  void log_rtt_(int64_t now);
 
 private:
   // config
@@ -37,13 +95,36 @@ private:
   const std::string my_id_;
   const std::string my_pw_;
   const std::string to_id_;
+  bool binary_ = false;
+  bool udp_ = false;
 
   // state
   std::atomic<bool> running_{false};
   std::thread thr_;
+  int      wake_fd_ = -1;         // eventfd: send_value/send_message/stop 이 I/O 스레드를 깨움
+  bool     bin_active_ = false;   // 현재 연결에서 협상됨 (I/O 스레드 전용)
+  uint16_t seq_ = 0;              // 바이너리 프레임 일련번호 (I/O 스레드 전용)
+  int      udp_fd_ = -1;          // 현재 연결의 UDP 소켓 (I/O 스레드 전용)
+  uint32_t udp_token_ = 0;        // 로그인 응답으로 받은 UDP 토큰
+  int64_t  led_interval_us_ = 0;  // SLOWDOWN 으로 정한 LED 송신 최소 간격 (I/O 스레드 전용, 재접속 시 해제)
+  int64_t  next_led_us_ = 0;      // 다음 LED 송신 가능 시각
+
+  // 수신 버퍼 (I/O 스레드 전용)
+  uint8_t rx_buf_[4096];
+  size_t  rx_len_ = 0;
+  Pending pending_[kPending];
+  int     pending_head_ = 0;
+  int64_t last_rtt_log_us_ = 0;
+  uint64_t last_rtt_count_ = 0;
 
   // queue
   std::mutex mu_;
-  std::condition_variable cv_;
-  std::deque<std::string> q_;
+  std::deque<Item> q_;
+  std::atomic<uint64_t> latest_{0};
+  std::atomic<uint64_t> coalesced_{0};
+
+  // stats
+  LatencyHistogram rtt_;
+  std::atomic<uint64_t> unacked_{0};
+  std::atomic<int> led_max_hz_{0};
 };
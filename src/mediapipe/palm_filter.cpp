@@ -0,0 +1,101 @@
+#include "palm_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+inline float Alpha(float cutoff_hz, float dt_s) {
+  const float tau = 1.0f / (2.0f * 3.14159265f * cutoff_hz);
+  return 1.0f / (1.0f + tau / dt_s);
+}
+} // namespace
+
+// ===== OneEuroFilter =====
+float OneEuroFilter::filter(float x, int64_t t_us) {
+  if (!primed_) {
+    primed_ = true;
+    x_ = x; dx_ = 0.f; t_us_ = t_us;
+    return x_;
+  }
+  float dt = (float)(t_us - t_us_) * 1e-6f;
+  if (dt <= 0.f) return x_;           // 같은/역순 타임스탬프는 무시
+  t_us_ = t_us;
+
+  const float raw_dx = (x - x_) / dt;
+  dx_ += Alpha(d_cutoff_, dt) * (raw_dx - dx_);
+  const float cutoff = min_cutoff_ + beta_ * std::fabs(dx_);
+  x_ += Alpha(cutoff, dt) * (x - x_);
+  return x_;
+}
+
+// ===== PalmFilter =====
+void PalmFilter::configure(const PalmFilterConfig& cfg) {
+  cfg_ = cfg;
+  fx_ = OneEuroFilter(cfg.min_cutoff, cfg.beta, cfg.d_cutoff);
+  fy_ = OneEuroFilter(cfg.min_cutoff, cfg.beta, cfg.d_cutoff);
+}
+
+void PalmFilter::update(float x, float y, int64_t t_us) {
+  fx_.filter(x, t_us);
+  fy_.filter(y, t_us);
+  t_us_ = t_us;
+}
+
+void PalmFilter::output(int64_t target_us, float& x, float& y) const {
+  x = fx_.value();
+  y = fy_.value();
+  if (!cfg_.predict) return;
+  int64_t h = std::clamp<int64_t>(target_us - t_us_, 0, cfg_.max_horizon_us);
+  const float hs = (float)h * 1e-6f;
+  x = std::clamp(x + fx_.velocity() * hs, 0.f, 1.f);
+  y = std::clamp(y + fy_.velocity() * hs, 0.f, 1.f);
+}
+
+// ===== HandFilterBank =====
+HandFilterBank::HandFilterBank(const PalmFilterConfig& cfg) {
+  for (auto& f : f_) f.configure(cfg);
+}
+
+void HandFilterBank::reset() {
+  for (int i = 0; i < kMaxHands; ++i) { f_[i].reset(); used_[i] = false; }
+}
+
+void HandFilterBank::update(const float* palm_x, const float* palm_y, int n, int64_t t_us,
+                            int64_t horizon_us, float* out_x, float* out_y) {
+  n = std::min(n, kMaxHands);
+  int assign[kMaxHands];
+  bool taken[kMaxHands] = {};
+
+  // 이전 필터 위치와 최근접 매칭 (손 수가 적어 그리디로 충분)
+  for (int i = 0; i < n; ++i) {
+    assign[i] = -1;
+    float best = kMatchDist * kMatchDist;
+    for (int k = 0; k < kMaxHands; ++k) {
+      if (!used_[k] || taken[k] || !f_[k].primed()) continue;
+      float dx = f_[k].x() - palm_x[i], dy = f_[k].y() - palm_y[i];
+      float d2 = dx * dx + dy * dy;
+      if (d2 < best) { best = d2; assign[i] = k; }
+    }
+    if (assign[i] >= 0) taken[assign[i]] = true;
+  }
+  // 매칭 안 된 손은 빈 필터를 새로 시작
+  for (int i = 0; i < n; ++i) {
+    if (assign[i] >= 0) continue;
+    for (int k = 0; k < kMaxHands; ++k) {
+      if (taken[k]) continue;
+      f_[k].reset();
+      assign[i] = k; taken[k] = true;
+      break;
+    }
+  }
+  for (int k = 0; k < kMaxHands; ++k) {
+    used_[k] = taken[k];
+    if (!taken[k]) f_[k].reset();
+  }
+
+  for (int i = 0; i < n; ++i) {
+    PalmFilter& f = f_[assign[i]];
+    f.update(palm_x[i], palm_y[i], t_us);
+    f.output(t_us + horizon_us, out_x[i], out_y[i]);
+  }
+}
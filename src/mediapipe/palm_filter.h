@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+
+#include "landmark_snapshot.h"
+
+// 손바닥 위치 필터: One Euro 필터 (정지 시 떨림 제거, 빠른 움직임에서는 지연 최소화)
+// + 선택적 등속 외삽 (파이프라인 지연만큼 앞을 예측해 LED 반영 시점 위치를 추정).
+// 모든 상태는 고정 크기 멤버이며 할당이 없다.
+
+class OneEuroFilter {
+public:
+  OneEuroFilter(float min_cutoff = 1.0f, float beta = 3.0f, float d_cutoff = 1.0f)
+    : min_cutoff_(min_cutoff), beta_(beta), d_cutoff_(d_cutoff) {}
+
+  // t_us 시각의 관측 x 를 넣고 필터 값 반환
+  float filter(float x, int64_t t_us);
+  // 필터된 속도 (단위/초)
+  float velocity() const { return dx_; }
+  float value() const { return x_; }
+  bool  primed() const { return primed_; }
+  void  reset() { primed_ = false; dx_ = 0.f; }
+
+private:
+  float min_cutoff_, beta_, d_cutoff_;
+  bool    primed_ = false;
+  float   x_ = 0.f, dx_ = 0.f;
+  int64_t t_us_ = 0;
+};
+
+struct PalmFilterConfig {
+  bool    enabled = true;
+  float   min_cutoff = 1.0f;    // Hz, 정지 시 차단 주파수
+  float   beta = 3.0f;          // 속도 비례 차단 주파수 증가율
+  float   d_cutoff = 1.0f;      // Hz, 속도 추정 저역통과
+  bool    predict = false;      // 등속 외삽 사용
+  int64_t max_horizon_us = 150000;   // 외삽 상한 (과도한 오버슈트 방지)
+  int64_t extra_latency_us = 0;      // 측정 구간 밖 지연 (네트워크 + LED 드라이버) 추정치
+};
+
+// 손 하나의 (x, y) 필터
+class PalmFilter {
+public:
+  void configure(const PalmFilterConfig& cfg);
+  void update(float x, float y, int64_t t_us);
+  // target_us 시각 위치. predict 꺼져 있으면 필터 값 그대로
+  void output(int64_t target_us, float& x, float& y) const;
+  void reset() { fx_.reset(); fy_.reset(); }
+  bool primed() const { return fx_.primed(); }
+  float x() const { return fx_.value(); }
+  float y() const { return fy_.value(); }
+
+private:
+  PalmFilterConfig cfg_;
+  OneEuroFilter fx_, fy_;
+  int64_t t_us_ = 0;
+};
+
+// 프레임 간 손 대응(최근접 매칭) + 손별 PalmFilter
+class HandFilterBank {
+public:
+  explicit HandFilterBank(const PalmFilterConfig& cfg = PalmFilterConfig());
+
+  // 이번 프레임 손바닥 관측 (정규화 좌표). 결과 out_x/out_y[i] 는 입력 i 번째 손의 필터(예측) 위치
+  // horizon_us: 관측 시각(t_us) 기준 외삽 시간
+  void update(const float* palm_x, const float* palm_y, int n, int64_t t_us,
+              int64_t horizon_us, float* out_x, float* out_y);
+  void reset();
+
+private:
+  static constexpr float kMatchDist = 0.2f;   // 정규화 좌표 매칭 게이트
+  PalmFilter f_[kMaxHands];
+  bool used_[kMaxHands] = {};
+};
@@ -0,0 +1,210 @@
+// palm_filter 트레이스 테스트: testdata/palm_trace.csv 를 HandFilterBank 에 재생해
+//   still : 정지 손 떨림(프레임 간 변화량) 감소
+//   move  : 등속 이동 시 지연 상한, 외삽(predict) 시 지연 감소
+//   gone  : 손이 빠진 뒤 슬롯 초기화 (다시 나타난 첫 프레임은 관측값 그대로)
+//   two   : 입력 순서가 바뀌어도 손별 슬롯 유지
+//   외삽 horizon 상한/음수 처리와 [0, 1] 클램프
+// 를 확인한다. 실패 시 0 이 아닌 값으로 종료.
+//
+//   ./palm_filter_test [testdata/palm_trace.csv]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "palm_filter.h"
+
+namespace {
+
+struct Sample {
+  int64_t t_us;
+  std::string seg;
+  int n;
+  float x[2], y[2];
+};
+
+struct Output {
+  float x[2], y[2];
+};
+
+int g_failures = 0;
+
+void Check(bool ok, const char* what, double value, double limit) {
+  std::printf("%-4s %-44s %10.5f (limit %.5f)\n", ok ? "ok" : "FAIL", what, value, limit);
+  if (!ok) ++g_failures;
+}
+
+bool LoadTrace(const char* path, std::vector<Sample>& out) {
+  FILE* fp = std::fopen(path, "r");
+  if (!fp) return false;
+  char line[256];
+  while (std::fgets(line, sizeof(line), fp)) {
+    if (line[0] == '#' || std::strncmp(line, "t_us", 4) == 0) continue;
+    Sample s{};
+    char seg[16];
+    long long t;
+    int got = std::sscanf(line, "%lld,%15[^,],%d,%f,%f,%f,%f", &t, seg, &s.n,
+                          &s.x[0], &s.y[0], &s.x[1], &s.y[1]);
+    if (got < 3 || got != 3 + 2 * s.n) continue;
+    s.t_us = t;
+    s.seg = seg;
+    out.push_back(s);
+  }
+  std::fclose(fp);
+  return !out.empty();
+}
+
+// 트레이스 전체를 bank 에 재생. 결과는 입력 순서 그대로
+std::vector<Output> Replay(const std::vector<Sample>& trace, const PalmFilterConfig& cfg,
+                           int64_t horizon_us) {
+  HandFilterBank bank(cfg);
+  std::vector<Output> out(trace.size());
+  for (size_t i = 0; i < trace.size(); ++i) {
+    const Sample& s = trace[i];
+    bank.update(s.x, s.y, s.n, s.t_us, horizon_us, out[i].x, out[i].y);
+  }
+  return out;
+}
+
+// 프레임 간 x 변화량의 RMS
+double StepRms(const std::vector<float>& v) {
+  double acc = 0;
+  for (size_t i = 1; i < v.size(); ++i) acc += (v[i] - v[i - 1]) * (v[i] - v[i - 1]);
+  return v.size() > 1 ? std::sqrt(acc / (v.size() - 1)) : 0;
+}
+
+// move 구간 raw x 의 직선 근사(최소제곱)를 기준으로 한 평균 지연 (초).
+// 필터 수렴 전 앞쪽 skip 프레임은 제외. target_off_us: 출력이 나타내는 시각 (관측 기준)
+double MoveLag(const std::vector<Sample>& trace, const std::vector<Output>& out, int skip,
+               int64_t target_off_us) {
+  std::vector<size_t> idx;
+  for (size_t i = 0; i < trace.size(); ++i)
+    if (trace[i].seg == "move") idx.push_back(i);
+  double st = 0, sx = 0, stt = 0, stx = 0;
+  for (size_t i : idx) {
+    double t = trace[i].t_us * 1e-6, x = trace[i].x[0];
+    st += t; sx += x; stt += t * t; stx += t * x;
+  }
+  const double n = (double)idx.size();
+  const double v = (n * stx - st * sx) / (n * stt - st * st);
+  const double b = (sx - v * st) / n;
+  double lag = 0;
+  int cnt = 0;
+  for (size_t k = skip; k < idx.size(); ++k) {
+    const size_t i = idx[k];
+    const double t = (trace[i].t_us + target_off_us) * 1e-6;
+    lag += (v * t + b - out[i].x[0]) / v;
+    ++cnt;
+  }
+  return cnt ? lag / cnt : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "testdata/palm_trace.csv";
+  std::vector<Sample> trace;
+  if (!LoadTrace(path, trace)) {
+    std::fprintf(stderr, "cannot load trace %s\n", path);
+    return 2;
+  }
+
+  PalmFilterConfig cfg;   // hand_palm_demo 기본값
+  const std::vector<Output> base = Replay(trace, cfg, 0);
+
+  // --- still: 떨림 감소 (수렴 후 구간)
+  {
+    std::vector<float> raw, filt;
+    int k = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+      if (trace[i].seg != "still" || k++ < 10) continue;
+      raw.push_back(trace[i].x[0]);
+      filt.push_back(base[i].x[0]);
+    }
+    const double ratio = StepRms(raw) / StepRms(filt);
+    Check(ratio >= 3.0, "still: jitter reduction (raw/filtered)", ratio, 3.0);
+  }
+
+  // --- move: 지연 상한, 외삽 시 지연 감소
+  const double lag = MoveLag(trace, base, 5, 0);
+  Check(lag <= 0.080, "move: lag without predict (s)", lag, 0.080);
+  {
+    PalmFilterConfig pc = cfg;
+    pc.predict = true;
+    const int64_t horizon = 60000;
+    const std::vector<Output> pred = Replay(trace, pc, horizon);
+    // 예측 출력은 t + horizon 시각을 나타냄
+    const double plag = MoveLag(trace, pred, 5, horizon);
+    Check(std::fabs(plag) < lag, "move: |lag| with 60 ms predict (s)", std::fabs(plag), lag);
+  }
+
+  // --- gone -> two: 손이 빠지면 슬롯 초기화. (0.70, 0.60) 은 이전 손 (0.80, 0.45) 의
+  //     매칭 게이트 안이지만 이어 붙지 않고 관측값 그대로 시작해야 함
+  {
+    size_t first = 0;
+    while (first < trace.size() && trace[first].seg != "two") ++first;
+    double err = 0;
+    for (int h = 0; h < trace[first].n; ++h)
+      err = std::fmax(err, std::fmax(std::fabs(base[first].x[h] - trace[first].x[h]),
+                                     std::fabs(base[first].y[h] - trace[first].y[h])));
+    Check(err < 1e-6, "gone: slot reset on reappearance", err, 1e-6);
+
+    // 입력 순서가 매 프레임 바뀌어도 출력 i 는 입력 i 의 손을 따라감
+    double worst = 0;
+    for (size_t i = first; i < trace.size(); ++i) {
+      for (int h = 0; h < trace[i].n; ++h) {
+        const bool left = trace[i].x[h] < 0.45f;
+        const float cx = left ? 0.20f : 0.70f, cy = left ? 0.50f : 0.60f;
+        worst = std::fmax(worst, std::hypot(base[i].x[h] - cx, base[i].y[h] - cy));
+      }
+    }
+    Check(worst < 0.02, "two: swapped order keeps per-hand slot", worst, 0.02);
+  }
+
+  // --- 외삽 horizon: 상한 클램프, 음수는 0, predict 꺼지면 필터 값
+  {
+    PalmFilterConfig pc = cfg;
+    pc.predict = true;
+    PalmFilter f;
+    f.configure(pc);
+    for (const Sample& s : trace) {
+      if (s.seg != "move") continue;
+      f.update(s.x[0], s.y[0], s.t_us);
+    }
+    float mx, my, bx, by, zx, zy, nx, ny;
+    int64_t last_move = 0;   // 마지막 update 시각 기준
+    for (const Sample& s : trace)
+      if (s.seg == "move") last_move = s.t_us;
+    f.output(last_move + pc.max_horizon_us, mx, my);
+    f.output(last_move + 10 * pc.max_horizon_us, bx, by);
+    f.output(last_move, zx, zy);
+    f.output(last_move - 50000, nx, ny);
+    Check(bx == mx && by == my, "horizon: beyond max clamps to max", std::fabs(bx - mx),
+          0.0);
+    Check(mx > zx, "horizon: max horizon leads filtered value", mx - zx, 0.0);
+    Check(nx == zx && ny == zy, "horizon: negative horizon is 0", std::fabs(nx - zx), 0.0);
+    Check(zx == f.x() && zy == f.y(), "horizon: zero horizon is filtered value",
+          std::fabs(zx - f.x()), 0.0);
+
+    // 가장자리 근처 빠른 이동: 외삽이 [0, 1] 을 넘지 않음
+    PalmFilter edge;
+    edge.configure(pc);
+    for (int i = 0; i < 10; ++i) edge.update(0.80f + 0.02f * i, 0.5f, 1000000 + i * 33333);
+    float ex, ey;
+    edge.output(1000000 + 9 * 33333 + pc.max_horizon_us, ex, ey);
+    Check(ex <= 1.0f && ex >= 0.99f, "horizon: output clamped to 1.0", ex, 1.0);
+
+    PalmFilter off;
+    off.configure(cfg);
+    for (int i = 0; i < 10; ++i) off.update(0.80f + 0.02f * i, 0.5f, 1000000 + i * 33333);
+    float ox, oy;
+    off.output(1000000 + 9 * 33333 + pc.max_horizon_us, ox, oy);
+    Check(ox == off.x(), "horizon: predict off returns filtered value", ox, off.x());
+  }
+
+  std::printf("%s\n", g_failures ? "FAILED" : "PASSED");
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+#include "v4l2_capture.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// POSIX / V4L2
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+constexpr int kNumBuffers = 4; // 캡처 1 + 핸드오프 슬롯 1 + 처리 1 + 여유 1
+
+int Xioctl(const V4l2Ops& ops, int fd, unsigned long req, void* arg) {
+  int r;
+  do { r = ops.ioctl(fd, req, arg); } while (r < 0 && errno == EINTR);
+  return r;
+}
+
+// ===== 커널 시스템 호출 =====
+int SysOpen(const char* path, int flags) { return ::open(path, flags); }
+int SysClose(int fd) { return ::close(fd); }
+int SysIoctl(int fd, unsigned long req, void* arg) { return ::ioctl(fd, req, arg); }
+int SysPoll(int fd, int timeout_ms) {
+  pollfd pfd{fd, POLLIN, 0};
+  return ::poll(&pfd, 1, timeout_ms);
+}
+void* SysMmap(size_t length, int fd, int64_t offset) {
+  return ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)offset);
+}
+int SysMunmap(void* addr, size_t length) { return ::munmap(addr, length); }
+
+constexpr V4l2Ops kSysOps = {SysOpen, SysClose, SysIoctl, SysPoll, SysMmap, SysMunmap};
+
+int64_t SteadyUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string FourccStr(uint32_t f) {
+  char s[5] = {(char)(f & 0xff), (char)((f >> 8) & 0xff),
+               (char)((f >> 16) & 0xff), (char)((f >> 24) & 0xff), 0};
+  return s;
+}
+
+} // namespace
+
+struct V4l2Capture::Impl {
+  struct Buf { void* start = MAP_FAILED; size_t length = 0; };
+
+  V4l2Ops ops;
+  int fd = -1;
+  std::vector<Buf> bufs;
+  std::atomic<bool> streaming{false};
+  uint32_t fourcc = 0;
+  int w = 0, h = 0, stride = 0;
+
+  void requeue(uint32_t index) {
+    if (!streaming.load(std::memory_order_acquire)) return;
+    v4l2_buffer b{};
+    b.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    b.memory = V4L2_MEMORY_MMAP;
+    b.index  = index;
+    if (Xioctl(ops, fd, VIDIOC_QBUF, &b) < 0)
+      std::cerr << "[V4L2] QBUF(" << index << ") fail: " << std::strerror(errno) << "\n";
+  }
+
+  void stop() {
+    if (!streaming.exchange(false)) return;
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Xioctl(ops, fd, VIDIOC_STREAMOFF, &type);
+  }
+
+  explicit Impl(const V4l2Ops& o) : ops(o) {}
+
+  ~Impl() {
+    stop();
+    for (auto& b : bufs) if (b.start != MAP_FAILED) ops.munmap(b.start, b.length);
+    if (fd >= 0) ops.close(fd);
+  }
+};
+
+V4l2Capture::V4l2Capture(std::string device, const V4l2Ops* ops)
+  : dev_(std::move(device)), ops_(ops ? *ops : kSysOps) {}
+
+V4l2Capture::~V4l2Capture() { close(); }
+
+bool V4l2Capture::open(int w, int h, int fps, bool prefer_mjpeg) {
+  close();
+  auto im = std::make_shared<Impl>(ops_);
+
+  im->fd = ops_.open(dev_.c_str(), O_RDWR | O_NONBLOCK);
+  if (im->fd < 0) {
+    std::cerr << "[V4L2] open " << dev_ << " fail: " << std::strerror(errno) << "\n";
+    return false;
+  }
+
+  v4l2_capability cap{};
+  if (Xioctl(ops_, im->fd, VIDIOC_QUERYCAP, &cap) < 0) {
+    std::cerr << "[V4L2] QUERYCAP fail: " << std::strerror(errno) << "\n";
+    return false;
+  }
+  uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+  if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+    std::cerr << "[V4L2] " << dev_ << " is not a streaming capture device\n";
+    return false;
+  }
+
+  // 포맷 협상: 드라이버가 다른 포맷으로 바꿔 돌려주면 다음 후보
+  const uint32_t order[2] = {
+    prefer_mjpeg ? (uint32_t)V4L2_PIX_FMT_MJPEG : (uint32_t)V4L2_PIX_FMT_YUYV,
+    prefer_mjpeg ? (uint32_t)V4L2_PIX_FMT_YUYV  : (uint32_t)V4L2_PIX_FMT_MJPEG,
+  };
+  bool fmt_ok = false;
+  for (uint32_t pf : order) {
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width       = w > 0 ? w : 640;
+    fmt.fmt.pix.height      = h > 0 ? h : 480;
+    fmt.fmt.pix.pixelformat = pf;
+    fmt.fmt.pix.field       = V4L2_FIELD_NONE;
+    if (Xioctl(ops_, im->fd, VIDIOC_S_FMT, &fmt) < 0) continue;
+    if (fmt.fmt.pix.pixelformat != pf) continue;
+    im->fourcc = pf;
+    im->w = (int)fmt.fmt.pix.width;
+    im->h = (int)fmt.fmt.pix.height;
+    im->stride = (pf == V4L2_PIX_FMT_YUYV) ? (int)fmt.fmt.pix.bytesperline : 0;
+    fmt_ok = true;
+    break;
+  }
+  if (!fmt_ok) { std::cerr << "[V4L2] no MJPG/YUYV format\n"; return false; }
+
+  if (fps > 0) {
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator   = 1;
+    parm.parm.capture.timeperframe.denominator = (uint32_t)fps;
+    Xioctl(ops_, im->fd, VIDIOC_S_PARM, &parm); // 실패해도 드라이버 기본값 사용
+  }
+
+  v4l2_requestbuffers req{};
+  req.count  = kNumBuffers;
+  req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  req.memory = V4L2_MEMORY_MMAP;
+  if (Xioctl(ops_, im->fd, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+    std::cerr << "[V4L2] REQBUFS fail\n";
+    return false;
+  }
+
+  im->bufs.resize(req.count);
+  for (uint32_t i = 0; i < req.count; ++i) {
+    v4l2_buffer b{};
+    b.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    b.memory = V4L2_MEMORY_MMAP;
+    b.index  = i;
+    if (Xioctl(ops_, im->fd, VIDIOC_QUERYBUF, &b) < 0) {
+      std::cerr << "[V4L2] QUERYBUF fail\n"; return false;
+    }
+    im->bufs[i].length = b.length;
+    im->bufs[i].start  = ops_.mmap(b.length, im->fd, b.m.offset);
+    if (im->bufs[i].start == MAP_FAILED) {
+      std::cerr << "[V4L2] mmap fail: " << std::strerror(errno) << "\n"; return false;
+    }
+    if (Xioctl(ops_, im->fd, VIDIOC_QBUF, &b) < 0) {
+      std::cerr << "[V4L2] QBUF fail\n"; return false;
+    }
+  }
+
+  v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (Xioctl(ops_, im->fd, VIDIOC_STREAMON, &type) < 0) {
+    std::cerr << "[V4L2] STREAMON fail: " << std::strerror(errno) << "\n";
+    return false;
+  }
+  im->streaming.store(true, std::memory_order_release);
+
+  std::cerr << "[V4L2] OK: " << dev_ << " " << FourccStr(im->fourcc) << " "
+            << im->w << "x" << im->h << ", " << req.count << " buffers\n";
+  im_ = std::move(im);
+  return true;
+}
+
+void V4l2Capture::close() {
+  if (!im_) return;
+  im_->stop();   // 남은 hold 해제 시 QBUF 생략, munmap 은 마지막 hold 가 사라질 때
+  im_.reset();
+}
+
+bool V4l2Capture::read(V4l2Frame& out, int timeout_ms) {
+  if (!im_) return false;
+  if (ops_.poll(im_->fd, timeout_ms) <= 0) return false;
+
+  v4l2_buffer b{};
+  b.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  b.memory = V4L2_MEMORY_MMAP;
+  if (Xioctl(ops_, im_->fd, VIDIOC_DQBUF, &b) < 0) {
+    if (errno != EAGAIN)
+      std::cerr << "[V4L2] DQBUF fail: " << std::strerror(errno) << "\n";
+    return false;
+  }
+  if (b.index >= im_->bufs.size()) return false;
+
+  // 손상 프레임은 바로 반환
+  if (b.flags & V4L2_BUF_FLAG_ERROR) { im_->requeue(b.index); return false; }
+
+  out.data   = static_cast<const uint8_t*>(im_->bufs[b.index].start);
+  out.bytes  = b.bytesused;
+  out.fourcc = im_->fourcc;
+  out.width  = im_->w;
+  out.height = im_->h;
+  out.stride = im_->stride;
+  out.sequence = b.sequence;
+  if ((b.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+    out.timestamp_us = (int64_t)b.timestamp.tv_sec * 1000000 + b.timestamp.tv_usec;
+  } else {
+    out.timestamp_us = SteadyUs();
+  }
+
+  std::shared_ptr<Impl> im = im_;
+  uint32_t index = b.index;
+  out.hold = std::shared_ptr<void>(nullptr, [im, index](void*) { im->requeue(index); });
+  return true;
+}
+
+int      V4l2Capture::width() const  { return im_ ? im_->w : 0; }
+int      V4l2Capture::height() const { return im_ ? im_->h : 0; }
+uint32_t V4l2Capture::fourcc() const { return im_ ? im_->fourcc : 0; }
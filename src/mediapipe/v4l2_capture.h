@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 드라이버 mmap 버퍼를 그대로 가리키는 캡처 프레임 (복사 없음).
+// hold 의 마지막 참조가 해제될 때 버퍼가 드라이버 큐로 반환(QBUF)된다.
+struct V4l2Frame {
+  const uint8_t* data = nullptr;
+  size_t   bytes = 0;          // bytesused
+  uint32_t fourcc = 0;         // V4L2_PIX_FMT_YUYV / V4L2_PIX_FMT_MJPEG
+  int      width = 0, height = 0;
+  int      stride = 0;         // bytesperline (MJPEG 은 0)
+  int64_t  timestamp_us = 0;   // 커널 캡처 타임스탬프 (CLOCK_MONOTONIC = steady_clock)
+  uint32_t sequence = 0;       // 드라이버 프레임 번호
+  std::shared_ptr<void> hold;
+};
+
+// 캡처가 쓰는 시스템 호출. 기본은 커널, 테스트에서는 가짜 디바이스로 바꿔 끼운다
+struct V4l2Ops {
+  int   (*open)(const char* path, int flags);
+  int   (*close)(int fd);
+  int   (*ioctl)(int fd, unsigned long req, void* arg);
+  int   (*poll)(int fd, int timeout_ms);          // 읽기 가능 대기. >0 준비, 0 timeout, <0 오류
+  void* (*mmap)(size_t length, int fd, int64_t offset);   // 실패 시 MAP_FAILED
+  int   (*munmap)(void* addr, size_t length);
+};
+
+// V4L2 mmap 스트리밍 캡처 (VIDIOC_REQBUFS/QBUF/DQBUF).
+// cv::VideoCapture 의 내부 복사를 피하고 커널 타임스탬프를 그대로 노출한다.
+// vivid 가상 디바이스(modprobe vivid)로도 동작한다.
+class V4l2Capture {
+public:
+  // ops 가 nullptr 이면 커널 시스템 호출 사용
+  explicit V4l2Capture(std::string device, const V4l2Ops* ops = nullptr);
+  ~V4l2Capture();
+
+  V4l2Capture(const V4l2Capture&) = delete;
+  V4l2Capture& operator=(const V4l2Capture&) = delete;
+
+  // 포맷 협상 + 버퍼 mmap + STREAMON. prefer_mjpeg 이면 MJPEG 먼저, 아니면 YUYV 먼저 시도
+  bool open(int w, int h, int fps, bool prefer_mjpeg = true);
+  void close();
+
+  // 다음 프레임 DQBUF (poll 대기). timeout/오류 시 false
+  bool read(V4l2Frame& out, int timeout_ms);
+
+  int      width() const;
+  int      height() const;
+  uint32_t fourcc() const;
+
+private:
+  // 내보낸 프레임이 캡처 객체보다 오래 살 수 있으므로 hold 와 공유
+  struct Impl;
+  const std::string dev_;
+  const V4l2Ops ops_;
+  std::shared_ptr<Impl> im_;
+};
@@ -0,0 +1,393 @@
+// v4l2_capture 테스트
+//   fake  : 가짜 디바이스(V4l2Ops)로 포맷 협상, DQBUF/QBUF 순환, 손상 프레임 반환,
+//           close 후 남은 hold 처리, open 실패 경로를 확인 (항상 실행)
+//   vivid : vivid 가상 디바이스가 있으면 실제 스트리밍으로 sequence/타임스탬프와
+//           버퍼 고갈 후 재개를 확인 (없으면 SKIP. sudo modprobe vivid)
+// 실패 시 0 이 아닌 값으로 종료.
+//
+//   ./v4l2_capture_test [/dev/videoN]
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+#include "v4l2_capture.h"
+
+namespace {
+
+int g_failures = 0;
+
+void Check(bool ok, const char* what) {
+  std::printf("%-4s %s\n", ok ? "ok" : "FAIL", what);
+  if (!ok) ++g_failures;
+}
+
+// ===== 가짜 디바이스 =====
+// 드라이버 큐(QBUF 순서)를 흉내 낸다. 한 번에 하나만 열 수 있다.
+struct FakeDevice {
+  // 설정
+  uint32_t caps = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+  std::vector<uint32_t> formats = {V4L2_PIX_FMT_YUYV};
+  uint32_t max_w = 640, max_h = 480;
+  uint32_t grant_bufs = 4;          // REQBUFS 에 돌려줄 버퍼 수
+  bool fail_open = false;
+  bool fail_streamon = false;
+
+  // 상태
+  bool open = false, streaming = false;
+  uint32_t w = 0, h = 0, fourcc = 0;
+  size_t buf_len = 0;
+  std::vector<std::vector<uint8_t>> mem;
+  std::vector<bool> queued, mapped;
+  std::deque<uint32_t> ready;       // DQBUF 대기 버퍼
+  uint32_t sequence = 0;
+  bool error_next = false;          // 다음 DQBUF 에 ERROR 플래그
+  int qbufs = 0, dqbufs = 0, bad_qbufs = 0, streamoffs = 0;
+
+  int mapped_count() const {
+    int n = 0;
+    for (bool m : mapped) n += m;
+    return n;
+  }
+};
+
+constexpr int kFakeFd = 42;
+FakeDevice* g_dev = nullptr;
+
+int FakeOpen(const char*, int) {
+  if (g_dev->fail_open || g_dev->open) { errno = ENOENT; return -1; }
+  g_dev->open = true;
+  return kFakeFd;
+}
+
+int FakeClose(int fd) {
+  if (fd != kFakeFd || !g_dev->open) { errno = EBADF; return -1; }
+  g_dev->open = false;
+  return 0;
+}
+
+int FakeIoctl(int fd, unsigned long req, void* arg) {
+  FakeDevice& d = *g_dev;
+  if (fd != kFakeFd || !d.open) { errno = EBADF; return -1; }
+  switch (req) {
+  case VIDIOC_QUERYCAP: {
+    auto* cap = static_cast<v4l2_capability*>(arg);
+    std::memset(cap, 0, sizeof(*cap));
+    std::strcpy((char*)cap->driver, "fake");
+    cap->capabilities = d.caps;
+    return 0;
+  }
+  case VIDIOC_S_FMT: {
+    auto* f = static_cast<v4l2_format*>(arg);
+    if (d.streaming) { errno = EBUSY; return -1; }
+    if (d.formats.empty()) { errno = EINVAL; return -1; }
+    // 지원하지 않는 포맷은 첫 지원 포맷으로 바꿔 돌려줌 (실제 드라이버 동작)
+    uint32_t pf = d.formats[0];
+    for (uint32_t x : d.formats) if (x == f->fmt.pix.pixelformat) pf = x;
+    f->fmt.pix.pixelformat = pf;
+    if (f->fmt.pix.width > d.max_w) f->fmt.pix.width = d.max_w;
+    if (f->fmt.pix.height > d.max_h) f->fmt.pix.height = d.max_h;
+    f->fmt.pix.bytesperline = pf == V4L2_PIX_FMT_YUYV ? f->fmt.pix.width * 2 : 0;
+    f->fmt.pix.sizeimage = f->fmt.pix.width * f->fmt.pix.height * 2;
+    d.w = f->fmt.pix.width; d.h = f->fmt.pix.height; d.fourcc = pf;
+    d.buf_len = f->fmt.pix.sizeimage;
+    return 0;
+  }
+  case VIDIOC_S_PARM:
+    return 0;
+  case VIDIOC_REQBUFS: {
+    auto* r = static_cast<v4l2_requestbuffers*>(arg);
+    r->count = d.grant_bufs;
+    d.mem.assign(r->count, std::vector<uint8_t>(d.buf_len));
+    d.queued.assign(r->count, false);
+    d.mapped.assign(r->count, false);
+    return 0;
+  }
+  case VIDIOC_QUERYBUF: {
+    auto* b = static_cast<v4l2_buffer*>(arg);
+    if (b->index >= d.mem.size()) { errno = EINVAL; return -1; }
+    b->length = (uint32_t)d.buf_len;
+    b->m.offset = b->index * (uint32_t)d.buf_len;
+    return 0;
+  }
+  case VIDIOC_QBUF: {
+    auto* b = static_cast<v4l2_buffer*>(arg);
+    if (b->index >= d.mem.size() || d.queued[b->index]) {
+      ++d.bad_qbufs;
+      errno = EINVAL;
+      return -1;
+    }
+    d.queued[b->index] = true;
+    d.ready.push_back(b->index);
+    ++d.qbufs;
+    return 0;
+  }
+  case VIDIOC_DQBUF: {
+    auto* b = static_cast<v4l2_buffer*>(arg);
+    if (!d.streaming) { errno = EINVAL; return -1; }
+    if (d.ready.empty()) { errno = EAGAIN; return -1; }
+    const uint32_t i = d.ready.front();
+    d.ready.pop_front();
+    d.queued[i] = false;
+    ++d.dqbufs;
+    d.mem[i][0] = (uint8_t)d.sequence;
+    b->index = i;
+    b->bytesused = (uint32_t)d.buf_len;
+    b->sequence = d.sequence;
+    b->timestamp.tv_sec = 100 + d.sequence;
+    b->timestamp.tv_usec = 500;
+    b->flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+    if (d.error_next) { b->flags |= V4L2_BUF_FLAG_ERROR; d.error_next = false; }
+    ++d.sequence;
+    return 0;
+  }
+  case VIDIOC_STREAMON:
+    if (d.fail_streamon) { errno = EIO; return -1; }
+    d.streaming = true;
+    return 0;
+  case VIDIOC_STREAMOFF:
+    // 드라이버는 STREAMOFF 때 큐의 버퍼를 모두 회수
+    d.streaming = false;
+    d.ready.clear();
+    d.queued.assign(d.queued.size(), false);
+    ++d.streamoffs;
+    return 0;
+  }
+  errno = ENOTTY;
+  return -1;
+}
+
+int FakePoll(int fd, int) {
+  if (fd != kFakeFd) return -1;
+  return g_dev->streaming && !g_dev->ready.empty() ? 1 : 0;
+}
+
+void* FakeMmap(size_t length, int fd, int64_t offset) {
+  FakeDevice& d = *g_dev;
+  if (fd != kFakeFd || length != d.buf_len || offset % (int64_t)d.buf_len) return MAP_FAILED;
+  const size_t i = (size_t)(offset / (int64_t)d.buf_len);
+  if (i >= d.mem.size() || d.mapped[i]) return MAP_FAILED;
+  d.mapped[i] = true;
+  return d.mem[i].data();
+}
+
+int FakeMunmap(void* addr, size_t) {
+  FakeDevice& d = *g_dev;
+  for (size_t i = 0; i < d.mem.size(); ++i) {
+    if (d.mem[i].data() == addr && d.mapped[i]) { d.mapped[i] = false; return 0; }
+  }
+  errno = EINVAL;
+  return -1;
+}
+
+constexpr V4l2Ops kFakeOps = {FakeOpen, FakeClose, FakeIoctl, FakePoll, FakeMmap, FakeMunmap};
+
+int BufIndex(const FakeDevice& d, const V4l2Frame& f) {
+  for (size_t i = 0; i < d.mem.size(); ++i)
+    if (d.mem[i].data() == f.data) return (int)i;
+  return -1;
+}
+
+void TestNegotiation() {
+  {
+    FakeDevice dev;   // YUYV 만 지원, 640x480 상한
+    g_dev = &dev;
+    V4l2Capture cap("/dev/fake", &kFakeOps);
+    const bool ok = cap.open(1280, 720, 30, /*prefer_mjpeg=*/true);
+    Check(ok && cap.fourcc() == V4L2_PIX_FMT_YUYV,
+          "negotiation: MJPEG preferred, falls back to YUYV");
+    Check(cap.width() == 640 && cap.height() == 480, "negotiation: driver-adjusted size");
+    V4l2Frame f;
+    Check(cap.read(f, 0) && f.stride == 1280, "negotiation: YUYV stride from bytesperline");
+  }
+  {
+    FakeDevice dev;
+    dev.formats = {V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_MJPEG};
+    g_dev = &dev;
+    V4l2Capture cap("/dev/fake", &kFakeOps);
+    Check(cap.open(640, 480, 30, true) && cap.fourcc() == V4L2_PIX_FMT_MJPEG,
+          "negotiation: MJPEG chosen when supported");
+    V4l2Frame f;
+    Check(cap.read(f, 0) && f.stride == 0, "negotiation: MJPEG stride is 0");
+    f.hold.reset();
+    cap.close();
+    Check(cap.open(640, 480, 30, false) && cap.fourcc() == V4L2_PIX_FMT_YUYV,
+          "negotiation: YUYV chosen when preferred");
+  }
+}
+
+void TestRequeue() {
+  FakeDevice dev;
+  g_dev = &dev;
+  V4l2Capture cap("/dev/fake", &kFakeOps);
+  if (!cap.open(640, 480, 30)) { Check(false, "requeue: open"); return; }
+  Check(dev.qbufs == 4 && dev.ready.size() == 4, "requeue: all buffers queued at open");
+
+  // hold 를 모두 잡고 있으면 드라이버 큐가 비어 더 읽을 수 없음
+  std::vector<V4l2Frame> held(4);
+  bool distinct = true, fields = true;
+  for (int i = 0; i < 4; ++i) {
+    if (!cap.read(held[i], 0)) { distinct = false; break; }
+    const int idx = BufIndex(dev, held[i]);
+    for (int j = 0; j < i; ++j) distinct &= idx != BufIndex(dev, held[j]);
+    fields &= idx >= 0 && held[i].sequence == (uint32_t)i && held[i].data[0] == (uint8_t)i &&
+              held[i].bytes == dev.buf_len &&
+              held[i].timestamp_us == (int64_t)(100 + i) * 1000000 + 500;
+  }
+  Check(distinct, "requeue: 4 reads map 4 distinct buffers");
+  Check(fields, "requeue: sequence, bytesused and kernel timestamp exposed");
+  V4l2Frame extra;
+  Check(!cap.read(extra, 0), "requeue: read fails while every buffer is held");
+
+  // hold 해제 = QBUF. 같은 버퍼가 다시 나옴
+  const int idx2 = BufIndex(dev, held[2]);
+  held[2].hold.reset();
+  Check(dev.qbufs == 5 && dev.queued[idx2], "requeue: releasing hold requeues the buffer");
+  V4l2Frame again;
+  Check(cap.read(again, 0) && BufIndex(dev, again) == idx2 && again.sequence == 4,
+        "requeue: requeued buffer is dequeued again");
+
+  // 복사된 hold 는 마지막 참조가 사라질 때 한 번만 QBUF
+  V4l2Frame copy = again;
+  again.hold.reset();
+  Check(dev.qbufs == 5, "requeue: no QBUF while a copy still holds the frame");
+  copy.hold.reset();
+  Check(dev.qbufs == 6, "requeue: QBUF once the last copy is released");
+
+  for (auto& f : held) f.hold.reset();
+  Check(dev.bad_qbufs == 0 && dev.ready.size() == 4, "requeue: no double QBUF, all buffers back");
+
+  // 손상 프레임은 내보내지 않고 바로 반환
+  dev.error_next = true;
+  const int before = dev.qbufs;
+  V4l2Frame bad;
+  Check(!cap.read(bad, 0) && dev.qbufs == before + 1 && dev.ready.size() == 4,
+        "requeue: error-flagged buffer requeued, not returned");
+  V4l2Frame good;
+  Check(cap.read(good, 0), "requeue: next frame after error is delivered");
+}
+
+void TestCloseWithHold() {
+  FakeDevice dev;
+  g_dev = &dev;
+  V4l2Frame f;
+  {
+    V4l2Capture cap("/dev/fake", &kFakeOps);
+    cap.open(640, 480, 30);
+    cap.read(f, 0);
+    cap.close();
+    Check(dev.streamoffs == 1 && dev.open && dev.mapped_count() == 4,
+          "close: STREAMOFF, mappings kept while a frame is held");
+    Check(f.data[0] == 0, "close: held frame data still readable");
+    V4l2Frame none;
+    Check(!cap.read(none, 0), "close: read after close fails");
+  }
+  const int qbufs = dev.qbufs;
+  f.hold.reset();
+  Check(dev.qbufs == qbufs && dev.bad_qbufs == 0, "close: no QBUF after STREAMOFF");
+  Check(!dev.open && dev.mapped_count() == 0, "close: last hold unmaps and closes fd");
+}
+
+void TestOpenErrors() {
+  struct Case {
+    const char* what;
+    void (*setup)(FakeDevice&);
+  };
+  const Case cases[] = {
+    {"open: device open failure", [](FakeDevice& d) { d.fail_open = true; }},
+    {"open: not a streaming device", [](FakeDevice& d) { d.caps = V4L2_CAP_VIDEO_CAPTURE; }},
+    {"open: no MJPG/YUYV format", [](FakeDevice& d) { d.formats.clear(); }},
+    {"open: REQBUFS grants < 2 buffers", [](FakeDevice& d) { d.grant_bufs = 1; }},
+    {"open: STREAMON failure", [](FakeDevice& d) { d.fail_streamon = true; }},
+  };
+  for (const Case& c : cases) {
+    FakeDevice dev;
+    c.setup(dev);
+    g_dev = &dev;
+    V4l2Capture cap("/dev/fake", &kFakeOps);
+    const bool ok = cap.open(640, 480, 30);
+    V4l2Frame f;
+    // 실패하면 fd/매핑을 남기지 않고 read 도 실패해야 함
+    Check(!ok && !dev.open && dev.mapped_count() == 0 && !cap.read(f, 0), c.what);
+  }
+}
+
+// ===== vivid =====
+std::string FindVivid() {
+  for (int i = 0; i < 64; ++i) {
+    const std::string path = "/dev/video" + std::to_string(i);
+    int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) continue;
+    v4l2_capability cap{};
+    const bool vivid = ::ioctl(fd, VIDIOC_QUERYCAP, &cap) == 0 &&
+                       std::strcmp((const char*)cap.driver, "vivid") == 0 &&
+                       (cap.device_caps & V4L2_CAP_VIDEO_CAPTURE) &&
+                       (cap.device_caps & V4L2_CAP_STREAMING);
+    ::close(fd);
+    if (vivid) return path;
+  }
+  return "";
+}
+
+void TestVivid(std::string path) {
+  if (path.empty()) path = FindVivid();
+  if (path.empty()) {
+    std::printf("SKIP vivid: no vivid capture device (sudo modprobe vivid)\n");
+    return;
+  }
+  std::printf("vivid: %s\n", path.c_str());
+  V4l2Capture cap(path);
+  if (!cap.open(640, 480, 30, /*prefer_mjpeg=*/false)) { Check(false, "vivid: open"); return; }
+  Check(cap.fourcc() == V4L2_PIX_FMT_YUYV && cap.width() > 0 && cap.height() > 0,
+        "vivid: YUYV negotiated");
+
+  bool ok = true, ordered = true, sized = true;
+  uint32_t last_seq = 0;
+  int64_t last_ts = 0;
+  for (int i = 0; i < 30 && ok; ++i) {
+    V4l2Frame f;
+    ok = cap.read(f, 1000);
+    if (!ok) break;
+    if (i > 0) ordered &= f.sequence > last_seq && f.timestamp_us > last_ts;
+    sized &= f.stride >= f.width * 2 && f.bytes >= (size_t)f.stride * f.height;
+    last_seq = f.sequence;
+    last_ts = f.timestamp_us;
+  }
+  Check(ok, "vivid: 30 frames read");
+  Check(ordered, "vivid: sequence and timestamp increase");
+  Check(sized, "vivid: bytesused covers stride x height");
+
+  // 모든 버퍼를 잡으면 읽기가 멈추고, 해제하면 재개
+  std::vector<V4l2Frame> held;
+  for (int i = 0; i < 16; ++i) {
+    V4l2Frame f;
+    if (!cap.read(f, 300)) break;
+    held.push_back(f);
+  }
+  Check(!held.empty() && held.size() < 16, "vivid: reads stop when all buffers are held");
+  held.clear();
+  V4l2Frame f;
+  Check(cap.read(f, 1000), "vivid: reads resume after holds are released");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  TestNegotiation();
+  TestRequeue();
+  TestCloseWithHold();
+  TestOpenErrors();
+  TestVivid(argc > 1 ? argv[1] : "");
+
+  std::printf("%s\n", g_failures ? "FAILED" : "PASSED");
+  return g_failures ? 1 : 0;
+}
@@ -4,6 +4,9 @@ CONFIG += c++17
 TARGET = AiotClient
 TEMPLATE = app
 
+# 서버와 공유하는 바이너리 LED 프레임 정의
+INCLUDEPATH += ../rsp_server
+
 SOURCES += \
     main.cpp \
     mainwidget.cpp \
@@ -15,7 +18,8 @@ HEADERS += \
     mainwidget.h \
     socketclient.h \
     tab1devcontrol.h \
-    tab2socketclient.h
+    tab2socketclient.h \
+    ../rsp_server/led_frame.h
 
 FORMS += \
     tab1devcontrol.ui \
@@ -1,9 +1,11 @@
 #include "socketclient.h"
+#include "led_frame.h"
 
 SocketClient::SocketClient(QWidget *parent)
     : QWidget{parent}
 {
     pQTcpSocket = new QTcpSocket();
+    ledClock.start();
 
     connect(pQTcpSocket, SIGNAL(connected()), this, SLOT(socketConnectServerSlot()));
     connect(pQTcpSocket, SIGNAL(disconnected()), this, SLOT(socketClosedServerSlot()));
@@ -32,6 +34,12 @@ void SocketClient::connectToServerSlot(bool &bFlag)
 
 void SocketClient::socketReadDataSlot()
 {
+    if(USEBINARY)
+    {
+        recvBuf.append(pQTcpSocket->readAll());
+        parseBinaryStream();
+        return;
+    }
     QByteArray byteRecvData;
     QString strRecvData;
     if(pQTcpSocket->bytesAvailable() > BLOCK_SIZE)
@@ -42,6 +50,39 @@ void SocketClient::socketReadDataSlot()
     emit socketRecvDataSig(strRecvData);
 
 }
+
+// 0xA5 로 시작하면 16바이트 프레임, 아니면 "\n" 까지 텍스트 한 줄
+void SocketClient::parseBinaryStream()
+{
+    while(!recvBuf.isEmpty())
+    {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(recvBuf.constData());
+        struct led_frame f;
+        int r = led_frame_decode(p, recvBuf.size(), &f);
+        if(r == 0)
+            return;     // 프레임 나머지 대기
+        if(r > 0)
+        {
+            recvBuf.remove(0, r);
+            if(f.type == LED_FRAME_UPDATE || f.type == LED_FRAME_SET)
+                emit socketRecvLedSig(f.value, f.type == LED_FRAME_UPDATE, f.seq, f.ts_us);
+            continue;
+        }
+
+        int nl = recvBuf.indexOf('\n');
+        if(nl < 0)
+        {
+            if(recvBuf.size() <= BLOCK_SIZE)
+                return; // 줄 나머지 대기
+            nl = recvBuf.size() - 1;
+        }
+        QByteArray line = recvBuf.left(nl + 1);
+        recvBuf.remove(0, nl + 1);
+        if(line.startsWith("[SERVER]Connected") && line.contains(LED_PROTO_BIN_TAG))
+            binActive = true;
+        emit socketRecvDataSig(QString::fromLocal8Bit(line));
+    }
+}
 void SocketClient::socketErrorSlot()
 {
     QString strError = pQTcpSocket->errorString();
@@ -50,6 +91,10 @@ void SocketClient::socketErrorSlot()
 void SocketClient::socketConnectServerSlot()
 {
     QString strIdPw ="["+LOGID+":"+LOGPW+"]";
+    if(USEBINARY)
+        strIdPw = "["+LOGID+":"+LOGPW+":"+LED_PROTO_BIN_TAG+"]";
+    binActive = false;
+    recvBuf.clear();
     QByteArray byteIdPw = strIdPw.toLocal8Bit();
     pQTcpSocket->write(byteIdPw);
 }
@@ -65,6 +110,24 @@ void SocketClient::socketWriteDataSlot(QString strData)
     pQTcpSocket->write(byteData);
 }
 
+void SocketClient::socketWriteLedSlot(int value)
+{
+    // 바이너리가 협상되지 않은 연결(구 서버, 재접속 직후)은 텍스트 명령으로
+    if(!binActive)
+    {
+        socketWriteDataSlot(QString("[KSH_QT]LED@0x%1").arg(value & 0xFF, 2, 16, QChar('0')));
+        return;
+    }
+    struct led_frame f = {};
+    f.type = LED_FRAME_SET;
+    f.value = static_cast<uint8_t>(value);
+    f.seq = ++ledSeq;
+    f.ts_us = static_cast<uint64_t>(ledClock.nsecsElapsed() / 1000);
+    uint8_t frame[LED_FRAME_SIZE];
+    led_frame_encode(&f, frame);
+    pQTcpSocket->write(reinterpret_cast<const char *>(frame), LED_FRAME_SIZE);
+}
+
 SocketClient::~SocketClient()
 {
 
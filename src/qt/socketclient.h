@@ -7,6 +7,7 @@
 #include <QInputDialog>
 #include <QDebug>
 #include <QMessageBox>
+#include <QElapsedTimer>
 
 #define BLOCK_SIZE 1024
 class SocketClient : public QWidget
@@ -17,13 +18,23 @@ class SocketClient : public QWidget
     int SERVERPORT = 5000;
     QString LOGID = "10";
     QString LOGPW = "PASSWD";
+    bool USEBINARY = false;     // true 면 로그인 시 바이너리 LED 프레임 협상
+    bool binActive = false;     // 서버가 "[SERVER]Connected BIN1" 으로 수락
+    QByteArray recvBuf;         // 바이너리 모드 수신 버퍼 (프레임/텍스트 줄 분리)
+    quint16 ledSeq = 0;
+    QElapsedTimer ledClock;
+
+    void parseBinaryStream();
 
 public:
     explicit SocketClient(QWidget *parent = nullptr);
     ~SocketClient();
+    bool isBinary() const { return binActive; }
 
 signals:
     void socketRecvDataSig(QString strRecvData);
+    // 바이너리 프레임 수신: isUpdate = 서버 LED_UPDATE, 아니면 다른 클라이언트의 LED 명령
+    void socketRecvLedSig(int value, bool isUpdate, quint16 seq, quint64 tsUs);
 
 private slots:
     void socketReadDataSlot();
@@ -34,6 +45,7 @@ public slots:
     void connectToServerSlot(bool &);
     void socketClosedServerSlot();
     void socketWriteDataSlot(QString);
+    void socketWriteLedSlot(int value);     // 바이너리 협상 시 프레임, 아니면 "[KSH_QT]LED@0xNN" 텍스트
 
 signals:
 };
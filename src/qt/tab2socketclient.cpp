@@ -11,6 +11,8 @@ Tab2SocketClient::Tab2SocketClient(QWidget* parent)
     pSocketClient = new SocketClient(this);
     connect(pSocketClient, SIGNAL(socketRecvDataSig(QString)), 
             this, SLOT(updateRecvDataSlot(QString)));
+    connect(pSocketClient, SIGNAL(socketRecvLedSig(int,bool,quint16,quint64)),
+            this, SLOT(updateRecvLedSlot(int,bool,quint16,quint64)));
 }
 
 Tab2SocketClient::~Tab2SocketClient()
@@ -52,13 +54,14 @@ void Tab2SocketClient::updateRecvDataSlot(QString strRecvData)
     QString logMessage = strTime + " | " + strRecvData;
     ui->pTErecvData->append(logMessage);
     
-    // LED 업데이트 처리 (서버에서 보낸 LED_UPDATE)
-    if (strRecvData.contains("[SERVER]LED_UPDATE@"))
+    // LED 업데이트 처리 (서버에서 보낸 LED_UPDATE, 로그인 직후 현재 상태 LED_STATE)
+    bool isState = strRecvData.contains("[SERVER]LED_STATE@");
+    if (isState || strRecvData.contains("[SERVER]LED_UPDATE@"))
     {
-        int atPos = strRecvData.indexOf("LED_UPDATE@");
+        int atPos = strRecvData.indexOf(isState ? "LED_STATE@" : "LED_UPDATE@");
         if (atPos != -1)
         {
-            QString ledStr = strRecvData.mid(atPos + 11);  // "LED_UPDATE@" 다음
+            QString ledStr = strRecvData.mid(strRecvData.indexOf('@', atPos) + 1);  // '@' 다음
             bool ok;
             int ledValue = 0;
             
@@ -74,7 +77,7 @@ void Tab2SocketClient::updateRecvDataSlot(QString strRecvData)
             if (ok)
             {
                 emit ledWriteSig(ledValue);
-                ui->pTErecvData->append(QString("  → LED Updated to: %1 (0x%2)")
+                ui->pTErecvData->append(QString(isState ? "  → LED State: %1 (0x%2)" : "  → LED Updated to: %1 (0x%2)")
                     .arg(ledValue)
                     .arg(ledValue, 2, 16, QChar('0')).toUpper());
             }
@@ -115,6 +118,22 @@ void Tab2SocketClient::updateRecvDataSlot(QString strRecvData)
     ui->pTErecvData->setTextCursor(cursor);
 }
 
+// 바이너리 프레임 수신 (문자열 파싱 없음)
+void Tab2SocketClient::updateRecvLedSlot(int ledValue, bool isUpdate, quint16 seq, quint64 tsUs)
+{
+    Q_UNUSED(tsUs);
+    emit ledWriteSig(ledValue);
+
+    QString strTime = QTime::currentTime().toString("hh:mm:ss");
+    if (isUpdate)
+        ui->pTErecvData->append(QString("%1 |   → LED Updated to: %2 (0x%3) seq=%4")
+            .arg(strTime).arg(ledValue)
+            .arg(ledValue, 2, 16, QChar('0')).arg(seq));
+    else
+        ui->pTErecvData->append(QString("%1 |   → Other client LED: %2")
+            .arg(strTime).arg(ledValue));
+}
+
 void Tab2SocketClient::on_pPBrecvDataClear_clicked()
 {
     ui->pTErecvData->clear();
@@ -147,6 +166,11 @@ void Tab2SocketClient::on_pPBSend_clicked()
 // Tab1에서 LED 값 변경시 호출
 void Tab2SocketClient::socketSendLedData(int ledNo)
 {
+    if (pSocketClient->isBinary())
+    {
+        pSocketClient->socketWriteLedSlot(ledNo);
+        return;
+    }
     QString data = QString("[KSH_QT]LED@0x%1").arg(ledNo, 2, 16, QChar('0'));
     pSocketClient->socketWriteDataSlot(data);
     
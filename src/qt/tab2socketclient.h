@@ -25,6 +25,7 @@ signals:
 private slots:
     void on_pPBserverConnect_toggled(bool checked);
     void updateRecvDataSlot(QString);
+    void updateRecvLedSlot(int, bool, quint16, quint64);
     void on_pPBrecvDataClear_clicked();
     void on_pPBSend_clicked();
 
@@ -0,0 +1,69 @@
+#include "hist.h"
+
+static int hist_index(uint64_t v)
+{
+    if (v < (1u << HIST_SUB_BITS))
+        return (int)v;
+    int e = 63 - __builtin_clzll(v);
+    int sub = (int)((v >> (e - HIST_SUB_BITS)) & ((1u << HIST_SUB_BITS) - 1));
+    int idx = ((e - HIST_SUB_BITS + 1) << HIST_SUB_BITS) + sub;
+    return idx < HIST_BUCKETS ? idx : HIST_BUCKETS - 1;
+}
+
+static int64_t hist_upper_bound(int idx)
+{
+    if (idx < (1 << HIST_SUB_BITS))
+        return idx;
+    int e = (idx >> HIST_SUB_BITS) + HIST_SUB_BITS - 1;
+    int sub = idx & ((1 << HIST_SUB_BITS) - 1);
+    return (((int64_t)(1 << HIST_SUB_BITS) + sub + 1) << (e - HIST_SUB_BITS)) - 1;
+}
+
+void hist_add(struct lat_hist *h, int64_t us)
+{
+    if (us < 0) us = 0;
+    h->buckets[hist_index((uint64_t)us)]++;
+    h->count++;
+    if (us > h->max) h->max = us;
+}
+
+void hist_add_atomic(struct lat_hist *h, int64_t us)
+{
+    if (us < 0) us = 0;
+    __atomic_fetch_add(&h->buckets[hist_index((uint64_t)us)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+    int64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+    while (us > max && !__atomic_compare_exchange_n(&h->max, &max, us, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void hist_snapshot(const struct lat_hist *src, struct lat_hist *dst)
+{
+    dst->name = src->name;
+    dst->count = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++)
+    {
+        dst->buckets[i] = __atomic_load_n(&src->buckets[i], __ATOMIC_RELAXED);
+        dst->count += dst->buckets[i];
+    }
+    dst->max = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+}
+
+int64_t hist_percentile(const struct lat_hist *h, double p)
+{
+    if (h->count == 0)
+        return 0;
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t acc = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++)
+    {
+        acc += h->buckets[i];
+        if (acc >= rank)
+        {
+            int64_t ub = hist_upper_bound(i);
+            return ub < h->max ? ub : h->max;
+        }
+    }
+    return h->max;
+}
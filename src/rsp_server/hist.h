@@ -0,0 +1,30 @@
+#ifndef HIST_H
+#define HIST_H
+
+#include <stdint.h>
+
+// 지연 히스토그램 (로그-선형 버킷, us 단위). ledkey_server 와 ledkey_load 가 같이 써서
+// 두 쪽 백분위수가 같은 버킷 경계로 계산된다.
+// 2^HIST_SUB_BITS 미만은 값 그대로, 그 위는 2의 거듭제곱 구간마다 2^HIST_SUB_BITS 개로 나눈다
+// (상대 오차 약 12.5%). 2^40 us 이상은 마지막 버킷에 모인다.
+#define HIST_SUB_BITS 3
+#define HIST_BUCKETS ((40 - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
+
+struct lat_hist
+{
+    const char *name;
+    uint64_t buckets[HIST_BUCKETS];
+    uint64_t count;
+    int64_t max;
+};
+
+// us 를 기록 (음수는 0 으로)
+void hist_add(struct lat_hist *h, int64_t us);
+// 다른 스레드가 읽는 히스토그램에 기록 (__atomic). 읽는 쪽은 hist_snapshot() 으로 복사해서 사용
+void hist_add_atomic(struct lat_hist *h, int64_t us);
+// hist_add_atomic() 으로 갱신 중인 src 를 dst 로 복사. count 는 복사한 버킷의 합으로 맞춘다
+void hist_snapshot(const struct lat_hist *src, struct lat_hist *dst);
+// p 백분위수 (0~100) 가 속한 버킷의 상한, 최댓값을 넘지 않게 자름. 비어 있으면 0
+int64_t hist_percentile(const struct lat_hist *h, double p);
+
+#endif // HIST_H
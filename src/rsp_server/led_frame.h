@@ -0,0 +1,74 @@
+#ifndef LED_FRAME_H
+#define LED_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 바이너리 LED 프레임 (16바이트 고정, 다중 바이트 필드는 빅엔디언)
+//
+//   0  1  | 2    | 3       | 4     | 5     | 6..7 | 8..15
+//   A5 5A | type | channel | value | flags | seq  | ts_us
+//
+// 로그인 문자열 끝에 ":BIN1" 을 붙이면 협상되고, 서버는 "[SERVER]Connected BIN1" 으로 응답한다.
+// 협상된 연결에서도 채팅 등 일반 메시지는 기존 텍스트("...\n") 그대로이며,
+// 0xA5 는 ASCII 텍스트에 나오지 않으므로 첫 바이트로 프레임/텍스트를 구분한다.
+// seq/ts_us 는 송신자 값이며 LED_UPDATE 가 그대로 되돌려준다(손실/왕복 지연 측정용).
+
+#define LED_FRAME_SIZE   16
+#define LED_FRAME_MAGIC0 0xA5
+#define LED_FRAME_MAGIC1 0x5A
+#define LED_PROTO_BIN_TAG "BIN1"
+
+// UDP 채널: 바이너리 로그인 응답 "[SERVER]Connected BIN1 UDP@xxxxxxxx" 의 32비트 토큰(hex)을
+// 앞에 붙인 데이터그램 [token(u32 BE) | frame] 을 같은 포트로 보낸다. 인증/채팅은 TCP 유지.
+// 서버는 seq 가 직전보다 오래된(순서 뒤바뀜/중복) 데이터그램을 버린다.
+#define LED_UDP_TAG      "UDP@"
+#define LED_UDP_DATAGRAM_SIZE (4 + LED_FRAME_SIZE)
+
+#define LED_FRAME_SET    0x01   // 클라이언트 -> 서버: LED 값 설정 (다른 클라이언트에게도 전달)
+#define LED_FRAME_UPDATE 0x02   // 서버 -> 클라이언트: LED 반영 알림 (LED_UPDATE)
+
+#define LED_FLAG_SNAPSHOT 0x01  // UPDATE flags: 로그인 직후 보내는 현재 상태 (seq/ts 는 마지막 명령 것)
+
+struct led_frame
+{
+    uint8_t type;
+    uint8_t channel;
+    uint8_t value;
+    uint8_t flags;
+    uint16_t seq;
+    uint64_t ts_us;
+};
+
+static inline void led_frame_encode(const struct led_frame *f, uint8_t *out)
+{
+    out[0] = LED_FRAME_MAGIC0;
+    out[1] = LED_FRAME_MAGIC1;
+    out[2] = f->type;
+    out[3] = f->channel;
+    out[4] = f->value;
+    out[5] = f->flags;
+    out[6] = (uint8_t)(f->seq >> 8);
+    out[7] = (uint8_t)f->seq;
+    for (int i = 0; i < 8; i++)
+        out[8 + i] = (uint8_t)(f->ts_us >> (56 - 8 * i));
+}
+
+// 반환: LED_FRAME_SIZE = 성공, 0 = 바이트 부족, -1 = 매직 불일치
+static inline int led_frame_decode(const uint8_t *in, size_t len, struct led_frame *f)
+{
+    if (len >= 1 && in[0] != LED_FRAME_MAGIC0) return -1;
+    if (len >= 2 && in[1] != LED_FRAME_MAGIC1) return -1;
+    if (len < LED_FRAME_SIZE) return 0;
+    f->type = in[2];
+    f->channel = in[3];
+    f->value = in[4];
+    f->flags = in[5];
+    f->seq = (uint16_t)((in[6] << 8) | in[7]);
+    f->ts_us = 0;
+    for (int i = 0; i < 8; i++)
+        f->ts_us = (f->ts_us << 8) | in[8 + i];
+    return LED_FRAME_SIZE;
+}
+
+#endif // LED_FRAME_H
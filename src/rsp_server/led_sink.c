@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "led_sink.h"
+
+static int64_t sink_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===== dev: 문자 디바이스 =====
+static int dev_write(struct led_sink *s, unsigned char value, unsigned char pattern, int64_t recv_us)
+{
+    (void)value;
+    (void)recv_us;
+    return write(s->fd, &pattern, sizeof(pattern)) == sizeof(pattern) ? 0 : -1;
+}
+
+static void dev_close(struct led_sink *s)
+{
+    close(s->fd);
+}
+
+static int dev_open(struct led_sink *s, const char *path)
+{
+    if (access(path, F_OK) != 0)
+    {
+        int ret = mknod(path, S_IRWXU | S_IRWXG | S_IFCHR, (230 << 8) | 0);
+        if (ret < 0)
+        {
+            perror("mknod()");
+        }
+    }
+
+    s->fd = open(path, O_RDWR | O_NDELAY);
+    if (s->fd < 0)
+    {
+        perror("Device open failed");
+        return -1;
+    }
+    printf("Device opened successfully\n");
+    unsigned char led_off = 0;
+    write(s->fd, &led_off, sizeof(led_off));
+    s->name = "dev";
+    s->write = dev_write;
+    s->close = dev_close;
+    return 0;
+}
+
+// ===== shm: 공유 메모리 상태 (seqlock) =====
+static int shm_write(struct led_sink *s, unsigned char value, unsigned char pattern, int64_t recv_us)
+{
+    (void)recv_us;
+    struct led_shm_state *st = s->state;
+    uint32_t seq = st->seq;
+    __atomic_store_n(&st->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    st->value = value;
+    st->pattern = pattern;
+    st->ts_us = (uint64_t)sink_now_us();
+    st->writes++;
+    __atomic_store_n(&st->seq, seq + 2, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static void shm_close(struct led_sink *s)
+{
+    munmap(s->state, sizeof(struct led_shm_state));
+    close(s->fd);
+}
+
+static int shm_sink_open(struct led_sink *s, const char *name)
+{
+    s->fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (s->fd < 0 || ftruncate(s->fd, sizeof(struct led_shm_state)) < 0)
+    {
+        perror("shm_open");
+        return -1;
+    }
+    struct led_shm_state *st = mmap(NULL, sizeof(*st), PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (st == MAP_FAILED)
+    {
+        perror("mmap");
+        close(s->fd);
+        return -1;
+    }
+    memset(st, 0, sizeof(*st));
+    st->magic = LED_SHM_MAGIC;
+    s->state = st;
+    s->name = "shm";
+    s->write = shm_write;
+    s->close = shm_close;
+    printf("LED state in shared memory /dev/shm%s\n", name);
+    return 0;
+}
+
+// ===== null =====
+static int null_write(struct led_sink *s, unsigned char value, unsigned char pattern, int64_t recv_us)
+{
+    (void)s;
+    (void)value;
+    (void)pattern;
+    (void)recv_us;
+    return 0;
+}
+
+static void null_close(struct led_sink *s)
+{
+    (void)s;
+}
+
+static void null_open(struct led_sink *s)
+{
+    s->fd = -1;
+    s->name = "null";
+    s->write = null_write;
+    s->close = null_close;
+}
+
+int led_sink_open(struct led_sink *s, const char *spec)
+{
+    memset(s, 0, sizeof(*s));
+    const char *arg = strchr(spec, ':');
+    size_t kind_len = arg ? (size_t)(arg - spec) : strlen(spec);
+    if (arg)
+        arg++;
+
+    if (strncmp(spec, "dev", kind_len) == 0 && kind_len == 3)
+        return dev_open(s, arg ? arg : LED_SINK_DEVICE);
+    if (strncmp(spec, "shm", kind_len) == 0 && kind_len == 3)
+        return shm_sink_open(s, arg ? arg : LED_SINK_SHM_NAME);
+    if (strncmp(spec, "null", kind_len) == 0 && kind_len == 4)
+    {
+        null_open(s);
+        return 0;
+    }
+    fprintf(stderr, "unknown LED sink '%s' (dev|shm|null)\n", spec);
+    return -1;
+}
@@ -0,0 +1,59 @@
+#ifndef LED_SINK_H
+#define LED_SINK_H
+
+#include <stdint.h>
+
+// LED 출력 대상(sink). 서버의 writer 스레드만 write 를 호출한다.
+//   dev  : 문자 디바이스 /dev/ledkey (기본, 커널 모듈이 GPIO 제어)
+//   shm  : 공유 메모리 상태 (하드웨어 없는 장비에서 로컬 관찰자가 시스템 콜 없이 폴링)
+//   null : 아무것도 하지 않음 (순수 파이프라인 벤치마크)
+// 어느 backend 든 LED_UPDATE 알림, 합치기/패턴 생략/속도 상한은 동일하게 동작한다.
+
+#define LED_SINK_DEVICE "/dev/ledkey"
+#define LED_SINK_SHM_NAME "/ledkey_state"
+#define LED_SHM_MAGIC 0x4c454431u   // "LED1"
+
+struct led_sink
+{
+    const char *name;
+    int (*write)(struct led_sink *s, unsigned char value, unsigned char pattern, int64_t recv_us);
+    void (*close)(struct led_sink *s);
+    int fd;
+    void *state;
+};
+
+// spec: "dev" / "dev:/path" / "shm" / "shm:/name" / "null". 반환: 0 성공, -1 실패
+int led_sink_open(struct led_sink *s, const char *spec);
+
+// shm backend 레이아웃 (shm_open(LED_SINK_SHM_NAME) + mmap, 읽기 전용으로 열어 폴링)
+// seq 는 seqlock: 홀수 = 쓰는 중. 읽기 전후 seq 가 같고 짝수일 때만 유효
+struct led_shm_state
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint8_t value;          // 마지막 다이얼 값
+    uint8_t pattern;        // value_to_led_pattern() 결과
+    uint8_t reserved[6];
+    uint64_t ts_us;         // 반영 시각 (CLOCK_MONOTONIC)
+    uint64_t writes;        // 누적 반영 수
+};
+
+// 관찰자용: 일관된 스냅샷 읽기 (시스템 콜 없음)
+static inline void led_shm_read(const volatile struct led_shm_state *st, struct led_shm_state *out)
+{
+    uint32_t s1, s2;
+    do
+    {
+        s1 = __atomic_load_n(&st->seq, __ATOMIC_ACQUIRE);
+        out->magic = st->magic;
+        out->value = st->value;
+        out->pattern = st->pattern;
+        out->ts_us = st->ts_us;
+        out->writes = st->writes;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&st->seq, __ATOMIC_RELAXED);
+    } while ((s1 & 1) || s1 != s2);
+    out->seq = s1;
+}
+
+#endif // LED_SINK_H
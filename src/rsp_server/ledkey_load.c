@@ -0,0 +1,534 @@
+// ledkey_server 부하/지연 측정 도구
+//
+// N 개 연결로 로그인(NetClient / SocketClient 와 같은 문자열) 후 클라이언트마다 정해진 빈도로
+// LED 명령을 보내고, [SERVER]LED_UPDATE 알림을 받아 처리량과 명령 -> 알림 지연 분위수를 출력한다.
+// /dev/ledkey 가 없는 시뮬레이션 모드 서버에도 그대로 동작한다.
+//
+//   ./ledkey_load --clients=50 --rate=60 --duration=10
+//   ./ledkey_load --clients=10 --rate=1000 --mode=bin --subscribers=20
+//
+// 모드:
+//   text : NetClient 기본   로그인 "id:pw\n",        명령 "<to>:LED@0xNN\n"
+//   qt   : SocketClient     로그인 "[id:pw]",        명령 "[KSH_QT]LED@0xNN\n"
+//   bin  : NetClient --bin  로그인 "id:pw:BIN1\n",   명령 16바이트 프레임 (seq/ts 에코로 정확히 매칭)
+//   udp  : NetClient --udp  bin + 프레임을 UDP 데이터그램(token + frame)으로
+//
+// 텍스트 알림에는 값만 있으므로 발신 클라이언트마다 겹치지 않는 값(i, i+N, i+2N ...)을 쓰고
+// 값으로 매칭한다 (발신자가 256 개를 넘으면 값이 겹쳐 근사치).
+// 서버는 연결별로 순서대로 처리하므로 매칭된 명령보다 오래된 대기 명령은 알림이 오지 않는다
+// (한 read 묶음에서 뒤 명령에 덮임). 이런 명령과 2초 안에 알림이 없는 명령은 unacked 로 센다.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "led_frame.h"
+#include "hist.h"
+
+#define PEND_SLOTS 64
+#define ACK_TIMEOUT_US 2000000
+#define RX_BUF 8192
+#define MAX_EVENTS 256
+
+enum load_mode { MODE_TEXT, MODE_QT, MODE_BIN, MODE_UDP };
+
+struct pending
+{
+    int64_t send_us;        // 0 = 빈 칸
+    uint16_t seq;
+    uint8_t value;
+};
+
+struct client
+{
+    int fd;
+    int udp_fd;
+    int sender;             // 0 = 알림만 받는 구독자(대시보드)
+    int binary;
+    uint32_t token;
+    uint16_t seq;
+    int value_base;         // 이 클라이언트 값: value_base + step * k (k < value_count)
+    int value_count;
+    int value_k;
+    int64_t next_send_us;
+    struct pending pend[PEND_SLOTS];
+    int pend_head;
+    char rx[RX_BUF];
+    int rx_len;
+};
+
+// 옵션
+const char *host = "127.0.0.1";
+int port = 5000;
+int n_clients = 10;
+int n_subscribers = 0;
+int rate_hz = 60;
+int duration_s = 10;
+int mode = MODE_TEXT;
+const char *to_id = "2";
+int update_hz = 0;          // > 0 이면 구독자 로그인에 ":HZn" 을 붙여 LED_UPDATE 속도 상한 요청
+
+struct client *clients;
+int n_conns;
+
+// 통계
+uint64_t st_sent, st_acked, st_unacked, st_updates, st_send_fail, st_disconnects, st_slowdown;
+uint64_t win_sent, win_updates, win_acked;
+
+// ===== 지연 히스토그램 (hist.h, 서버와 같은 버킷) =====
+struct lat_hist hist_ack = { .name = "led -> ack" };   // LED 명령 송신 -> 해당 LED_UPDATE 수신
+
+int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===== 연결 =====
+static int connect_client(struct client *c, int idx)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1)
+        return -1;
+
+    c->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (c->fd < 0)
+        return -1;
+    if (connect(c->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(c->fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // 로그인 문자열은 클라이언트 구현과 동일 (Qt 는 "[...]", NetClient 는 '\n' 으로 끝)
+    char login[64];
+    char hz[16] = "";
+    if (update_hz > 0 && !c->sender)
+        snprintf(hz, sizeof(hz), ":HZ%d", update_hz);
+    if (mode == MODE_QT)
+        snprintf(login, sizeof(login), "[load%d:PASSWD%s]", idx, hz);
+    else if (mode == MODE_TEXT)
+        snprintf(login, sizeof(login), "load%d:PASSWD%s\n", idx, hz);
+    else
+        snprintf(login, sizeof(login), "load%d:PASSWD:" LED_PROTO_BIN_TAG "%s\n", idx, hz);
+    if (send(c->fd, login, strlen(login), 0) != (ssize_t)strlen(login))
+    {
+        close(c->fd);
+        return -1;
+    }
+
+    // 바이너리는 NetClient 처럼 응답을 1초 기다려 BIN1/UDP 토큰 확인
+    c->udp_fd = -1;
+    if (mode == MODE_BIN || mode == MODE_UDP)
+    {
+        struct timeval tv = { 1, 0 };
+        setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        // 응답 줄만 읽음 (뒤따르는 상태 스냅샷 프레임은 수신 루프가 처리)
+        char reply[128];
+        ssize_t r = recv(c->fd, reply, sizeof(reply) - 1, MSG_PEEK);
+        if (r > 0)
+        {
+            char *nl = memchr(reply, '\n', r);
+            if (nl)
+                r = nl - reply + 1;
+            r = recv(c->fd, reply, r, 0);
+        }
+        if (r > 0)
+        {
+            reply[r] = '\0';
+            c->binary = strstr(reply, LED_PROTO_BIN_TAG) != NULL;
+            const char *tag = strstr(reply, LED_UDP_TAG);
+            unsigned token = 0;
+            if (mode == MODE_UDP && tag && sscanf(tag + strlen(LED_UDP_TAG), "%8x", &token) == 1 && token)
+            {
+                c->token = token;
+                c->udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+                if (c->udp_fd >= 0 && connect(c->udp_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+                {
+                    close(c->udp_fd);
+                    c->udp_fd = -1;
+                }
+            }
+        }
+        tv.tv_sec = 0;
+        setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        if (!c->binary)
+            fprintf(stderr, "load%d: server did not accept binary frames, using text\n", idx);
+    }
+
+    fcntl(c->fd, F_SETFL, fcntl(c->fd, F_GETFL, 0) | O_NONBLOCK);
+    return 0;
+}
+
+static void close_client(struct client *c)
+{
+    if (c->fd >= 0)
+        close(c->fd);
+    if (c->udp_fd >= 0)
+        close(c->udp_fd);
+    c->fd = c->udp_fd = -1;
+    st_disconnects++;
+}
+
+// ===== 송신 =====
+static void send_led(struct client *c, int64_t now)
+{
+    uint8_t buf[64];
+    int len;
+    int fd = c->fd;
+    int step = n_clients < 256 ? n_clients : 256;
+    uint8_t value = (uint8_t)(c->value_base + step * c->value_k);
+    c->value_k = (c->value_k + 1) % c->value_count;
+    c->seq++;
+
+    if (c->binary)
+    {
+        struct led_frame f = { .type = LED_FRAME_SET, .value = value, .seq = c->seq, .ts_us = (uint64_t)now };
+        if (c->udp_fd >= 0)
+        {
+            buf[0] = (uint8_t)(c->token >> 24);
+            buf[1] = (uint8_t)(c->token >> 16);
+            buf[2] = (uint8_t)(c->token >> 8);
+            buf[3] = (uint8_t)c->token;
+            led_frame_encode(&f, buf + 4);
+            len = LED_UDP_DATAGRAM_SIZE;
+            fd = c->udp_fd;
+        }
+        else
+        {
+            led_frame_encode(&f, buf);
+            len = LED_FRAME_SIZE;
+        }
+    }
+    else if (mode == MODE_QT)
+        len = snprintf((char *)buf, sizeof(buf), "[KSH_QT]LED@0x%02x\n", value);
+    else
+        len = snprintf((char *)buf, sizeof(buf), "%s:LED@0x%02x\n", to_id, value);
+
+    ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+    if (n != len)
+    {
+        // 송신 버퍼가 찬 경우(서버가 못 따라옴)는 이번 명령을 건너뜀
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            close_client(c);
+        st_send_fail++;
+        return;
+    }
+
+    struct pending *p = &c->pend[c->pend_head];
+    if (p->send_us)
+        st_unacked++;       // 링이 한 바퀴 돌도록 알림이 없음
+    p->send_us = now;
+    p->seq = c->seq;
+    p->value = value;
+    c->pend_head = (c->pend_head + 1) % PEND_SLOTS;
+    st_sent++;
+    win_sent++;
+}
+
+// ===== 수신 =====
+static void on_update(struct client *c, int binary, uint8_t value, uint16_t seq, uint64_t ts_us, int64_t now)
+{
+    st_updates++;
+    win_updates++;
+    if (!c->sender)
+        return;
+
+    // 가장 오래된 대기 명령부터 찾음. 찾으면 그보다 오래된 명령은 알림이 오지 않음
+    for (int k = 0; k < PEND_SLOTS; k++)
+    {
+        struct pending *p = &c->pend[(c->pend_head + k) % PEND_SLOTS];
+        if (!p->send_us)
+            continue;
+        if (binary ? (p->seq == seq && (uint64_t)p->send_us == ts_us) : p->value == value)
+        {
+            hist_add(&hist_ack, now - p->send_us);
+            p->send_us = 0;
+            st_acked++;
+            win_acked++;
+            for (int j = 0; j < k; j++)
+            {
+                struct pending *old = &c->pend[(c->pend_head + j) % PEND_SLOTS];
+                if (old->send_us)
+                {
+                    old->send_us = 0;
+                    st_unacked++;
+                }
+            }
+            return;
+        }
+    }
+}
+
+static void parse_rx(struct client *c, int64_t now)
+{
+    int pos = 0;
+    while (pos < c->rx_len)
+    {
+        uint8_t *b = (uint8_t *)c->rx + pos;
+        int avail = c->rx_len - pos;
+        if (b[0] == LED_FRAME_MAGIC0)
+        {
+            struct led_frame f;
+            int r = led_frame_decode(b, avail, &f);
+            if (r == 0)
+                break;
+            if (r > 0)
+            {
+                if (f.type == LED_FRAME_UPDATE && !(f.flags & LED_FLAG_SNAPSHOT))
+                    on_update(c, 1, f.value, f.seq, f.ts_us, now);
+                pos += r;
+                continue;
+            }
+        }
+        uint8_t *nl = memchr(b, '\n', avail);
+        if (!nl)
+        {
+            if (pos == 0 && c->rx_len == RX_BUF)
+                pos = c->rx_len;    // 개행 없는 긴 줄은 버림
+            break;
+        }
+        *nl = '\0';
+        const char *tag = strstr((char *)b, "[SERVER]LED_UPDATE@0x");
+        if (tag)
+            on_update(c, 0, (uint8_t)strtoul(tag + 21, NULL, 16), 0, 0, now);
+        else if (strncmp((char *)b, "[SERVER]SLOWDOWN@", 17) == 0)
+            st_slowdown++;      // 부하 도구는 속도를 낮추지 않고 수만 셈
+        pos += (int)(nl - b) + 1;
+    }
+    c->rx_len -= pos;
+    if (c->rx_len > 0 && pos > 0)
+        memmove(c->rx, c->rx + pos, c->rx_len);
+}
+
+static void on_readable(struct client *c)
+{
+    for (;;)
+    {
+        ssize_t n = recv(c->fd, c->rx + c->rx_len, RX_BUF - c->rx_len, 0);
+        if (n > 0)
+        {
+            c->rx_len += (int)n;
+            parse_rx(c, now_us());
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if (n < 0 && errno == EINTR)
+            continue;
+        fprintf(stderr, "connection closed by server (fd %d)\n", c->fd);
+        close_client(c);
+        return;
+    }
+}
+
+static void expire_pending(int64_t now)
+{
+    for (int i = 0; i < n_conns; i++)
+    {
+        struct client *c = &clients[i];
+        for (int k = 0; k < PEND_SLOTS; k++)
+        {
+            if (c->pend[k].send_us && now - c->pend[k].send_us > ACK_TIMEOUT_US)
+            {
+                c->pend[k].send_us = 0;
+                st_unacked++;
+            }
+        }
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--host=IP] [--port=N] [--clients=N] [--subscribers=N]\n"
+            "          [--rate=HZ(15~1000)] [--duration=S] [--mode=text|qt|bin|udp] [--to=ID]\n"
+            "          [--update-hz=N]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--host=", 7) == 0)
+            host = argv[i] + 7;
+        else if (strncmp(argv[i], "--port=", 7) == 0)
+            port = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--clients=", 10) == 0)
+            n_clients = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--subscribers=", 14) == 0)
+            n_subscribers = atoi(argv[i] + 14);
+        else if (strncmp(argv[i], "--rate=", 7) == 0)
+            rate_hz = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--duration=", 11) == 0)
+            duration_s = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--update-hz=", 12) == 0)
+            update_hz = atoi(argv[i] + 12);
+        else if (strncmp(argv[i], "--to=", 5) == 0)
+            to_id = argv[i] + 5;
+        else if (strcmp(argv[i], "--mode=text") == 0)
+            mode = MODE_TEXT;
+        else if (strcmp(argv[i], "--mode=qt") == 0)
+            mode = MODE_QT;
+        else if (strcmp(argv[i], "--mode=bin") == 0)
+            mode = MODE_BIN;
+        else if (strcmp(argv[i], "--mode=udp") == 0)
+            mode = MODE_UDP;
+        else
+            usage(argv[0]);
+    }
+    if (n_clients < 0 || n_subscribers < 0 || n_clients + n_subscribers <= 0 ||
+        rate_hz < 15 || rate_hz > 1000 || duration_s <= 0)
+        usage(argv[0]);
+
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    n_conns = n_clients + n_subscribers;
+    clients = calloc(n_conns, sizeof(*clients));
+    int epfd = epoll_create1(0);
+    if (!clients || epfd < 0)
+    {
+        perror("init");
+        return 1;
+    }
+
+    // 연결 + 로그인. 발신 시작 시각은 주기 안에서 고르게 흩어 동시 burst 를 피함
+    int64_t interval_us = 1000000 / rate_hz;
+    int64_t start = now_us();
+    for (int i = 0; i < n_conns; i++)
+    {
+        struct client *c = &clients[i];
+        c->sender = i < n_clients;
+        int step = n_clients < 256 ? n_clients : 256;
+        c->value_base = i % step;
+        c->value_count = (255 - c->value_base) / step + 1;
+        if (connect_client(c, i) < 0)
+        {
+            fprintf(stderr, "connect/login failed at client %d: %s\n", i, strerror(errno));
+            return 1;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+    }
+    int64_t t0 = now_us();
+    for (int i = 0; i < n_clients; i++)
+        clients[i].next_send_us = t0 + interval_us * i / (n_clients ? n_clients : 1);
+    printf("[LOAD] %d senders x %d Hz + %d subscribers, mode %s, connected in %lld ms\n",
+           n_clients, rate_hz, n_subscribers,
+           mode == MODE_TEXT ? "text" : mode == MODE_QT ? "qt" : mode == MODE_BIN ? "bin" : "udp",
+           (long long)(t0 - start) / 1000);
+
+    int64_t end = t0 + (int64_t)duration_s * 1000000;
+    int64_t next_report = t0 + 1000000;
+    struct epoll_event events[MAX_EVENTS];
+    for (;;)
+    {
+        int64_t now = now_us();
+
+        // 송신 주기가 된 클라이언트
+        int64_t next_due = end;
+        if (now < end)
+        {
+            for (int i = 0; i < n_clients; i++)
+            {
+                struct client *c = &clients[i];
+                if (c->fd < 0)
+                    continue;
+                if (c->next_send_us <= now)
+                {
+                    send_led(c, now);
+                    c->next_send_us += interval_us;
+                    if (c->next_send_us < now)      // 밀렸으면 따라잡지 않고 건너뜀
+                        c->next_send_us = now + interval_us;
+                }
+                if (c->next_send_us < next_due)
+                    next_due = c->next_send_us;
+            }
+        }
+        else if (now > end + ACK_TIMEOUT_US / 4)
+        {
+            break;      // 끝난 뒤 늦은 알림을 잠시 더 받음
+        }
+        else
+        {
+            next_due = end + ACK_TIMEOUT_US / 4;
+        }
+
+        if (now >= next_report)
+        {
+            printf("[LOAD] t=%2llds sent %6llu/s  acked %6llu/s  updates rx %7llu/s  p50 %5lld us  p99 %6lld us\n",
+                   (long long)(now - t0) / 1000000, (unsigned long long)win_sent,
+                   (unsigned long long)win_acked, (unsigned long long)win_updates,
+                   (long long)hist_percentile(&hist_ack, 50), (long long)hist_percentile(&hist_ack, 99));
+            fflush(stdout);
+            win_sent = win_updates = win_acked = 0;
+            next_report += 1000000;
+            expire_pending(now);
+        }
+
+        int timeout_ms = (int)((next_due - now_us()) / 1000);
+        if (timeout_ms < 0)
+            timeout_ms = 0;
+        int n = epoll_wait(epfd, events, MAX_EVENTS, timeout_ms);
+        for (int k = 0; k < n; k++)
+        {
+            struct client *c = &clients[events[k].data.u32];
+            if (c->fd >= 0)
+                on_readable(c);
+        }
+    }
+
+    // 끝까지 알림이 없는 명령은 unacked
+    for (int i = 0; i < n_clients; i++)
+    {
+        for (int k = 0; k < PEND_SLOTS; k++)
+        {
+            if (clients[i].pend[k].send_us)
+                st_unacked++;
+        }
+    }
+
+    double secs = duration_s;
+    printf("\n[LOAD] summary: sent %llu (%.0f cmd/s), acked %llu (%.1f%%), unacked %llu, send skipped %llu, disconnects %llu\n",
+           (unsigned long long)st_sent, st_sent / secs, (unsigned long long)st_acked,
+           st_sent ? 100.0 * st_acked / st_sent : 0.0, (unsigned long long)st_unacked,
+           (unsigned long long)st_send_fail, (unsigned long long)st_disconnects);
+    printf("[LOAD] notifications received %llu (%.0f /s over %d connections), slowdown notices %llu\n",
+           (unsigned long long)st_updates, st_updates / secs, n_conns, (unsigned long long)st_slowdown);
+    printf("[LOAD] cmd -> notify latency (us): p50 %lld  p90 %lld  p99 %lld  p99.9 %lld  max %lld\n",
+           (long long)hist_percentile(&hist_ack, 50), (long long)hist_percentile(&hist_ack, 90),
+           (long long)hist_percentile(&hist_ack, 99), (long long)hist_percentile(&hist_ack, 99.9), (long long)hist_ack.max);
+
+    for (int i = 0; i < n_conns; i++)
+    {
+        if (clients[i].fd >= 0)
+            close(clients[i].fd);
+        if (clients[i].udp_fd >= 0)
+            close(clients[i].udp_fd);
+    }
+    return 0;
+}
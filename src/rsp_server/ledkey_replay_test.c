@@ -0,0 +1,338 @@
+// ledkey_server 수신 분할/병합 재생 테스트
+//
+// 서버를 --sink=null 로 띄운 뒤 TCP 스트림을 일부러 잘게 쪼개거나(한 메시지가 여러 read)
+// 여러 메시지를 한 세그먼트로 붙여(여러 메시지가 한 read) 보내고, 각 클라이언트가 받은 내용을 확인한다.
+// '\n' / ']' 로 끝낸 로그인 뒤에 곧바로 붙어 온 명령이 로그인에 섞이지 않는지가 주 대상이다.
+//
+//   ./ledkey_replay_test                       (./ledkey_server, 포트 5600)
+//   ./ledkey_replay_test --server=PATH --port=N
+//
+// 실패한 항목을 출력하고 하나라도 실패하면 1 로 끝난다.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "led_frame.h"
+
+#define RX_MAX 4096
+#define WAIT_MS 1000            // 기대한 내용이 올 때까지 최대 대기
+#define QUIET_MS 150            // "오지 않아야 함" 확인 시 대기
+#define FRAG_GAP_US 20000       // 조각 사이 간격 (서버가 따로 read 하도록)
+
+struct peer
+{
+    const char *name;
+    int fd;
+    char rx[RX_MAX];
+    int rx_len;
+};
+
+static const char *server_path = "./ledkey_server";
+static int port = 5600;
+static pid_t server_pid = -1;
+static int failures = 0;
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void check(int ok, const char *what)
+{
+    printf("%s %s\n", ok ? "[ OK ]" : "[FAIL]", what);
+    if (!ok)
+        failures++;
+}
+
+static int start_server(void)
+{
+    char port_arg[32];
+    snprintf(port_arg, sizeof(port_arg), "--port=%d", port);
+    server_pid = fork();
+    if (server_pid < 0)
+        return -1;
+    if (server_pid == 0)
+    {
+        // 서버 출력은 버림 (실패 분석은 서버를 직접 띄워서)
+        if (!freopen("/dev/null", "w", stdout))
+            _exit(127);
+        execl(server_path, server_path, port_arg, "--sink=null", "--log-level=warn", (char *)NULL);
+        _exit(127);
+    }
+    return 0;
+}
+
+static void stop_server(void)
+{
+    if (server_pid > 0)
+    {
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, NULL, 0);
+    }
+}
+
+// 서버가 뜰 때까지 재시도하며 접속
+static int peer_connect(struct peer *p, const char *name)
+{
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+    int64_t deadline = now_ms() + 2000;
+    for (;;)
+    {
+        p->fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(p->fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+            break;
+        close(p->fd);
+        if (now_ms() > deadline)
+        {
+            p->fd = -1;
+            return -1;
+        }
+        usleep(20000);
+    }
+    int one = 1;
+    setsockopt(p->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return 0;
+}
+
+static void peer_close(struct peer *p)
+{
+    if (p->fd >= 0)
+        close(p->fd);
+    p->fd = -1;
+}
+
+// 세그먼트 하나로 송신 (TCP_NODELAY 라 보통 그대로 한 read 로 도착)
+static void seg(struct peer *p, const void *data, size_t len)
+{
+    if (send(p->fd, data, len, 0) != (ssize_t)len)
+        perror("send");
+    usleep(FRAG_GAP_US);
+}
+
+static void seg_str(struct peer *p, const char *s)
+{
+    seg(p, s, strlen(s));
+}
+
+// timeout_ms 동안 받은 것을 rx 에 쌓는다. want 가 보이면 바로 1
+static int peer_wait(struct peer *p, const void *want, size_t want_len, int timeout_ms)
+{
+    int64_t deadline = now_ms() + timeout_ms;
+    for (;;)
+    {
+        if (want && memmem(p->rx, p->rx_len, want, want_len))
+            return 1;
+        int left = (int)(deadline - now_ms());
+        if (left <= 0)
+            return 0;
+        struct pollfd pfd = { .fd = p->fd, .events = POLLIN };
+        if (poll(&pfd, 1, left) <= 0)
+            continue;
+        int n = recv(p->fd, p->rx + p->rx_len, RX_MAX - p->rx_len, 0);
+        if (n <= 0)
+            return 0;
+        p->rx_len += n;
+    }
+}
+
+static void expect(struct peer *p, const char *want, const char *what)
+{
+    char msg[256];
+    int ok = peer_wait(p, want, strlen(want), WAIT_MS);
+    snprintf(msg, sizeof(msg), "%s: %s", p->name, what);
+    check(ok, msg);
+}
+
+static void expect_frame(struct peer *p, const struct led_frame *f, const char *what)
+{
+    uint8_t raw[LED_FRAME_SIZE];
+    led_frame_encode(f, raw);
+    char msg[256];
+    int ok = peer_wait(p, raw, 8, WAIT_MS);     // magic/type/ch/value/flags/seq (ts 는 제외)
+    snprintf(msg, sizeof(msg), "%s: %s", p->name, what);
+    check(ok, msg);
+}
+
+static void expect_none(struct peer *p, const char *unwanted, const char *what)
+{
+    char msg[256];
+    peer_wait(p, NULL, 0, QUIET_MS);
+    snprintf(msg, sizeof(msg), "%s: %s", p->name, what);
+    check(!memmem(p->rx, p->rx_len, unwanted, strlen(unwanted)), msg);
+}
+
+static void login(struct peer *p, const char *name, const char *line)
+{
+    if (peer_connect(p, name) < 0)
+    {
+        check(0, "connect");
+        return;
+    }
+    seg_str(p, line);
+    expect(p, "[SERVER]Connected", "login reply");
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--server=", 9) == 0)
+            server_path = argv[i] + 9;
+        else if (strncmp(argv[i], "--port=", 7) == 0)
+            port = atoi(argv[i] + 7);
+        else
+        {
+            fprintf(stderr, "usage: %s [--server=PATH] [--port=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+    if (start_server() < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+
+    // 받는 쪽: 텍스트 클라이언트 "2" 와 Qt 대시보드 "dash"
+    struct peer dev, dash;
+    login(&dev, "2", "2:PASSWD\n");
+    login(&dash, "dash", "[dash:PASSWD]");
+    expect(&dash, "[SERVER]LED_STATE@0x00\n", "login snapshot tagged LED_STATE");
+    expect_none(&dash, "[SERVER]LED_UPDATE@", "no LED_UPDATE without a command");
+
+    // 1. 개행 없는 로그인에 명령이 붙어 옴 (이전 NetClient 가 만들던 형태): 첫 read 전체가 로그인.
+    //    접속 중인 id 로 끝나는지 추측해 자르지 않으므로 명령은 전달되지 않는다
+    struct peer a;
+    if (peer_connect(&a, "3") == 0)
+    {
+        seg_str(&a, "3:PASSWD2:LED@0x40\n");
+        expect(&a, "[SERVER]Connected\n", "glued legacy login replied");
+        expect_none(&dev, "LED@0x40", "no id probing inside an unterminated login");
+        seg_str(&dash, "[3]ping\n");
+        expect(&a, "[3]ping\n", "login id parsed as \"3\"");
+    }
+    peer_close(&a);
+
+    // 2. '\n' 로 끝낸 로그인 + 명령 두 개가 한 세그먼트
+    if (peer_connect(&a, "31") == 0)
+    {
+        seg_str(&a, "31:PASSWD\n2:LED@0x41\n2:hello\n");
+        expect(&a, "[SERVER]Connected\n", "coalesced login replied");
+        expect(&dev, "2:LED@0x41\n", "LED command after terminated login");
+        expect(&dev, "2:hello\n", "chat after terminated login");
+        expect(&dash, "[SERVER]LED_UPDATE@0x41\n", "LED_UPDATE after terminated login");
+    }
+    peer_close(&a);
+
+    // 3. 로그인 뒤 명령이 조각나서 도착 (경계가 메시지 중간에 걸침)
+    if (peer_connect(&a, "4") == 0)
+    {
+        seg_str(&a, "4:PASSWD\n2:LE");
+        seg_str(&a, "D@0x4");
+        seg_str(&a, "2\n");
+        expect(&a, "[SERVER]Connected\n", "fragmented login replied");
+        expect(&dev, "2:LED@0x42\n", "fragmented LED command reassembled");
+        expect(&dash, "[SERVER]LED_UPDATE@0x42\n", "LED_UPDATE after fragmented input");
+        seg_str(&dash, "[4]ping\n");
+        expect(&a, "[4]ping\n", "fragmented login id parsed as \"4\"");
+        expect_none(&dev, "SWD", "no login fragment leaked as a message");
+    }
+    peer_close(&a);
+
+    // 4. 개행 없는 로그인만 (이전 클라이언트): 기다리지 않고 바로 로그인
+    if (peer_connect(&a, "5") == 0)
+    {
+        int64_t t0 = now_ms();
+        seg_str(&a, "5:PASSWD");
+        expect(&a, "[SERVER]Connected\n", "unterminated login accepted");
+        check(now_ms() - t0 < 40, "unterminated login not held back");
+        seg_str(&a, "2:LED@0x43\n");
+        expect(&dash, "[SERVER]LED_UPDATE@0x43\n", "LED command after unterminated login");
+    }
+    peer_close(&a);
+
+    // 5. Qt 로그인 "[id:pw]" 가 조각나고 뒤에 명령이 붙음
+    if (peer_connect(&a, "6") == 0)
+    {
+        seg_str(&a, "[6:PA");
+        seg_str(&a, "SSWD][KSH_QT]LED@0x44\n[2]hi\n");
+        expect(&a, "[SERVER]Connected\n", "fragmented Qt login replied");
+        expect(&dash, "[SERVER]LED_UPDATE@0x44\n", "LED command coalesced with Qt login");
+        expect(&dev, "[2]hi\n", "routed chat coalesced with Qt login");
+    }
+    peer_close(&a);
+
+    // 6. 바이너리: 로그인 + SET 프레임 한 세그먼트, 다음 프레임은 두 조각
+    if (peer_connect(&a, "7") == 0)
+    {
+        uint8_t buf[64];
+        const char *line = "7:PASSWD:" LED_PROTO_BIN_TAG "\n";
+        size_t len = strlen(line);
+        memcpy(buf, line, len);
+        struct led_frame f = { .type = LED_FRAME_SET, .value = 0x45, .seq = 1 };
+        led_frame_encode(&f, buf + len);
+        seg(&a, buf, len + LED_FRAME_SIZE);
+        expect(&a, "[SERVER]Connected " LED_PROTO_BIN_TAG, "binary login replied");
+        struct led_frame snap = { .type = LED_FRAME_UPDATE, .value = 0x44, .flags = LED_FLAG_SNAPSHOT };
+        expect_frame(&a, &snap, "binary login snapshot flagged LED_FLAG_SNAPSHOT");
+        expect(&dash, "[SERVER]LED_UPDATE@0x45\n", "frame coalesced with binary login");
+
+        struct led_frame g = { .type = LED_FRAME_SET, .value = 0x46, .seq = 2 };
+        led_frame_encode(&g, buf);
+        seg(&a, buf, 5);
+        seg(&a, buf + 5, LED_FRAME_SIZE - 5);
+        expect(&dash, "[SERVER]LED_UPDATE@0x46\n", "fragmented frame reassembled");
+        struct led_frame u = { .type = LED_FRAME_UPDATE, .value = 0x46, .seq = 2 };
+        expect_frame(&a, &u, "binary LED_UPDATE for own frame");
+    }
+    peer_close(&a);
+
+    // 7. 라우팅: 로그인해 있는 id 로 시작하는 메시지만 그 id 에게, 나머지는 전체로
+    if (peer_connect(&a, "10") == 0)
+    {
+        seg_str(&a, "[10:PASSWD]");
+        expect(&a, "[SERVER]Connected\n", "Qt client \"10\" logged in");
+        seg_str(&a, "[KSH_QT]LED@0x47\n");
+        expect(&dev, "[KSH_QT]LED@0x47\n", "Qt tagged LED command reaches other clients");
+        expect(&dash, "[KSH_QT]LED@0x47\n", "Qt tagged LED command reaches dashboard");
+        expect(&dash, "[SERVER]LED_UPDATE@0x47\n", "Qt tagged LED command applied");
+        seg_str(&a, "note: hi\n");
+        expect(&dev, "note: hi\n", "unaddressed \"word:\" chat broadcast");
+        expect(&dash, "note: hi\n", "unaddressed \"word:\" chat reaches dashboard");
+        seg_str(&a, "[ALLMSG]all\n");
+        expect(&dev, "[ALLMSG]all\n", "[ALLMSG] broadcast");
+        seg_str(&a, "[2]secret\n2:private\n");
+        expect(&dev, "[2]secret\n", "\"[id]\" chat delivered to logged-in id");
+        expect(&dev, "2:private\n", "\"id:\" chat delivered to logged-in id");
+        expect_none(&dash, "secret", "\"[id]\" chat not broadcast");
+        expect_none(&dash, "private", "\"id:\" chat not broadcast");
+    }
+    peer_close(&a);
+
+    peer_close(&dev);
+    peer_close(&dash);
+    stop_server();
+    printf("%s (%d failed)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
@@ -1,81 +1,983 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <ctype.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/resource.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
 #include <pthread.h>
 
-#define PORT 5000
-#define DEVICE_FILENAME "/dev/ledkey"
+#include "led_frame.h"
+#include "log_ring.h"
+#include "led_sink.h"
+#include "hist.h"
+
+#define PORT 5000                           // 기본 포트 (--port=)
 #define BUFFER_SIZE 1024
-#define MAX_CLIENTS 10
+#define MAX_CLIENTS 4096            // 동시 연결 상한 (fd 한도도 시작 시 올림)
+#define MAX_EVENTS 256
+#define OUTBUF_LIMIT_DEFAULT (256 * 1024)   // 연결별 송신 대기 상한 (--outbuf-kb=)
+#define PEND_MAX 128                        // 합쳐 두는 LED 메시지 최대 길이
+#define ID_BUCKETS 1024                     // id -> 연결 인덱스 해시 버킷 수 (2의 거듭제곱)
+#define TOKEN_BUCKETS 1024                  // UDP 토큰 -> 연결 해시 버킷 수 (2의 거듭제곱)
+#define ID_LEN 50
+#define DEV_MAX_HZ_DEFAULT 100              // 디바이스 write 최대 빈도 (--dev-max-hz=, 0 = 제한 없음)
+#define LOGIN_HZ_TAG ":HZ"                  // 로그인 끝 ":HZ30" = LED_UPDATE 를 초당 30 번까지만 받음
+#define LED_RATE_DEFAULT 200                // 연결별 LED 명령 반영 빈도 상한 (--led-rate=HZ[:BURST])
+#define LED_BURST_DEFAULT 50
+#define CHAT_RATE_DEFAULT 50                // 연결별 채팅 메시지 빈도 상한 (--chat-rate=HZ[:BURST])
+#define CHAT_BURST_DEFAULT 50
+#define SLOWDOWN_INTERVAL_US 1000000        // [SERVER]SLOWDOWN 알림 최소 간격
+#define TICK_LAT_MAX 4096                   // tick 모드: 한 tick 동안 지연을 기록할 LED 반영 수
 
-int dev_fd;
-int client_fds[MAX_CLIENTS];
-pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
+// 송신 메시지 종류와 송신 버퍼가 밀렸을 때의 정책
+enum msg_class { MSG_CTRL, MSG_LED_CMD, MSG_LED_UPDATE, MSG_CHAT, MSG_CLASSES };
+enum overflow_policy
+{
+    POLICY_COALESCE,     // 밀려 있는 동안 LED 상태는 최신 하나만 보관, 버퍼가 비면 전송
+    POLICY_DROP,         // 상한 초과 시 메시지 버림
+    POLICY_DISCONNECT,   // 상한 초과 시 연결 종료
+};
+const char *class_names[MSG_CLASSES] = { "ctrl", "led", "led_update", "chat" };
+// 서버 응답은 항상 disconnect, LED 는 coalesce, 채팅은 drop (--led-policy= --chat-policy=)
+int class_policy[MSG_CLASSES] = { POLICY_DISCONNECT, POLICY_COALESCE, POLICY_COALESCE, POLICY_DROP };
+size_t outbuf_limit = OUTBUF_LIMIT_DEFAULT;
 
-// 클라이언트 추가
-void add_client(int fd)
+// 토큰 버킷: 초당 rate 개씩 채워지고 burst 개까지 쌓임 (rate 0 = 제한 없음)
+struct rate_limit
+{
+    double rate;
+    double burst;
+};
+struct token_bucket
+{
+    double tokens;
+    int64_t last_us;
+};
+struct rate_limit led_limit = { LED_RATE_DEFAULT, LED_BURST_DEFAULT };
+struct rate_limit chat_limit = { CHAT_RATE_DEFAULT, CHAT_BURST_DEFAULT };
+
+// read 한 번에서 추출한 LED 명령 중 마지막 하나 (묶음 끝에서 한 번만 반영)
+struct led_batch
+{
+    int pending;
+    int binary;                 // 1 = raw 프레임, 0 = text 줄
+    int udp;                    // UDP 데이터그램으로 받음
+    int show;                   // 로그 샘플링에 걸린 명령
+    struct led_frame f;
+    uint8_t raw[LED_FRAME_SIZE];
+    char text[BUFFER_SIZE];
+};
+
+// 연결별 상태. 단일 스레드 epoll 루프에서만 접근
+struct conn
+{
+    int fd;
+    int idx;                // active[] 위치
+    int logged_in;
+    int binary;             // 바이너리 프레임 협상
+    int dead;               // 이벤트 처리 후 닫음
+    uint32_t token;         // UDP 토큰 (0 = 없음)
+    struct conn *token_next;    // 같은 해시 버킷의 다음 연결 (token_index)
+    int last_seq;           // TCP 바이너리 seq (-1 = 없음)
+    int udp_last_seq;       // UDP 로 마지막 반영한 seq
+    char id[ID_LEN];
+    struct conn *id_next;   // 같은 해시 버킷의 다음 연결 (id_index)
+    int indexed;
+    char in[BUFFER_SIZE];   // 수신 버퍼: 아직 완성되지 않은 줄/프레임이 다음 read 까지 남음
+    int in_len;
+    char *out;              // 송신 대기 버퍼 [out_off, out_len)
+    size_t out_off, out_len, out_cap;
+    // 밀려 있는 동안 합쳐 둔 최신 LED 메시지 (MSG_LED_CMD, MSG_LED_UPDATE)
+    char pend[2][PEND_MAX];
+    uint8_t pend_len[2];
+    // 지연 지표
+    int64_t backlog_since;  // 송신 대기가 생긴 시각 (0 = 비어 있음)
+    size_t backlog_max;
+    uint64_t n_dropped;
+    uint64_t n_coalesced;
+    // LED 상태 메시지 속도 상한 (0 = 없음). 다음 전송 시각 전에 온 것은 종류별 최신 하나만 보류
+    int64_t state_interval_us;
+    int64_t next_state_us[2];
+    char held[2][PEND_MAX];
+    uint8_t held_len[2];
+    // 속도 제한: LED 명령은 토큰이 없으면 최신 하나만 보류, 채팅은 버림
+    struct token_bucket led_bucket;
+    struct token_bucket chat_bucket;
+    struct led_batch deferred;
+    int64_t deferred_recv_us;
+    int64_t slowdown_sent_us;
+    uint64_t n_led_throttled;
+    uint64_t n_chat_throttled;
+};
+
+struct led_sink sink;        // LED 출력 대상 (--sink=dev|shm|null)
+// 현재 LED 상태 (마지막으로 반영한 명령). 로그인 직후 스냅샷으로 보냄
+struct led_state
+{
+    unsigned char value;
+    uint16_t seq;
+    uint64_t ts_us;
+} led_state;
+int update_max_hz = 0;      // 구독자별 LED 상태 메시지 최대 빈도 (--update-max-hz=, 0 = 제한 없음)
+int n_held;                 // 속도 상한으로 보류 중인 메시지 수
+int n_deferred;             // 속도 제한으로 LED 명령을 보류 중인 연결 수
+// tick 모드 (--tick-hz=): 서버 응답 외 송신은 모아 두었다가 timerfd tick 마다 연결당 writev 한 번
+int tick_hz = 0;
+int64_t tick_recv_us[TICK_LAT_MAX];     // 이번 tick 에 반영한 LED 명령의 수신 시각 (알림 지연 기록용)
+int n_tick_recv;
+int dev_max_hz = DEV_MAX_HZ_DEFAULT;
+int epfd;
+struct conn **conns;        // fd 로 인덱스
+int conns_cap;
+struct conn *active[MAX_CLIENTS];   // 브로드캐스트 순회용 조밀 배열
+int n_active;
+uint64_t slow_drops = 0;
+// 로그인 id -> 연결. 같은 id 로 여러 연결이 있으면 모두 받는다
+struct conn *id_index[ID_BUCKETS];
+// UDP 토큰 -> 연결 (토큰은 난수라 하위 비트를 그대로 버킷으로)
+struct conn *token_index[TOKEN_BUCKETS];
+
+void print_client_lag(void);
+void print_client_throttle(void);
+
+// epoll 등록 데이터: 리스너/UDP/signalfd 는 음수 태그, 클라이언트는 fd
+#define EV_LISTEN (-1)
+#define EV_UDP    (-2)
+#define EV_SIGNAL (-3)
+#define EV_TICK   (-4)
+
+// ===== 지연 히스토그램 (hist.h) =====
+// 서버 구간: 메시지 수신(read 반환) -> /dev/ledkey write 완료, -> LED_UPDATE 알림 송신 완료
+// (dev write 는 writer 스레드가 hist_add_atomic 으로 기록, 출력 시 hist_snapshot 으로 복사)
+struct lat_hist hist_dev_write = { .name = "recv -> dev write" };
+struct lat_hist hist_notify = { .name = "recv -> notify" };
+// TCP 바이너리 프레임 수신 수 / seq 공백으로 추정한 손실 수
+uint64_t bin_frames = 0;
+uint64_t bin_lost = 0;
+// UDP 데이터그램: 반영 / seq 공백으로 추정한 손실 / 오래된 seq 로 버림 / 토큰 불일치
+uint64_t udp_rx = 0;
+uint64_t udp_lost = 0;
+uint64_t udp_stale = 0;
+uint64_t udp_bad = 0;
+// TCP LED 명령 수 / 같은 read 묶음 안에서 뒤 명령에 덮여 디바이스 write 를 생략한 수
+uint64_t led_cmds = 0;
+uint64_t led_superseded = 0;
+// 송신 바이트 (메시지 종류별, 송신 버퍼에 들어간 것 기준) / 메시지 경로별 수
+uint64_t tx_bytes[MSG_CLASSES];
+uint64_t msg_directed = 0;      // "[id]..." / "id:..." -> 대상 연결만
+uint64_t msg_fanout = 0;        // "[ALLMSG]..." 또는 주소 없음 -> 전체
+uint64_t msg_noroute = 0;       // 대상 id 가 발신자 자신뿐
+// 상태 동기화: 로그인 스냅샷 / 보낸 LED 상태 메시지 / 속도 상한으로 보류했다 보낸 것 / 보류 중 덮인 것
+uint64_t state_snapshots = 0;
+uint64_t state_sent = 0;
+uint64_t state_released = 0;
+uint64_t state_collapsed = 0;
+// 속도 제한: 보류한 LED 명령 / 보류 중 더 새 명령에 덮인 것 / 버린 채팅 / 보낸 SLOWDOWN 알림
+uint64_t led_throttled = 0;
+uint64_t led_throttle_superseded = 0;
+uint64_t chat_throttled = 0;
+uint64_t slowdown_sent = 0;
+uint64_t throttled_clients = 0;     // 속도 제한에 한 번이라도 걸린 연결 수 (누적)
+// 송신 시스템 콜 수 (send / writev) / tick 수 / tick 안에서 더 새 LED 메시지에 덮인 것
+uint64_t tx_syscalls = 0;
+uint64_t ticks = 0;
+uint64_t tick_collapsed = 0;
+
+int64_t now_us(void)
 {
-    pthread_mutex_lock(&clients_mutex);
-    for(int i = 0; i < MAX_CLIENTS; i++)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===== LED 디바이스 writer 스레드 =====
+// 이벤트 루프는 최신값 우편함에 값을 덮어쓰고 eventfd 로 깨우기만 한다. sink write
+// (dev 면 GPIO 8개 토글 + printk)는 이 스레드 하나만 하므로 순서가 보장되고 루프를 막지 않는다.
+// 우편함: [recv_us | valid(1) | value(8)], 0 = 비어 있음. __atomic 으로만 접근
+uint64_t dev_mailbox;
+int dev_wake_fd = -1;
+// 디바이스 통계 (writer 스레드가 갱신, 출력은 근사치)
+uint64_t dev_posted;        // 반영 요청된 LED 값
+uint64_t dev_writes;        // 실제 write
+uint64_t dev_coalesced;     // write 전에 새 값으로 덮임
+uint64_t dev_unchanged;     // 직전 패턴과 같아 생략
+uint64_t dev_failed;        // sink write 실패 (값은 우편함에 되돌려 재시도)
+
+#define DEV_SLOT_VALID (1ull << 8)
+#define DEV_RETRY_US 100000         // sink write 실패 후 재시도 간격
+
+unsigned char value_to_led_pattern(unsigned char value);
+
+// LED 값 반영 요청 (이벤트 루프)
+void dev_post(unsigned char value, int64_t recv_us)
+{
+    uint64_t slot = ((uint64_t)recv_us << 9) | DEV_SLOT_VALID | value;
+    uint64_t prev = __atomic_exchange_n(&dev_mailbox, slot, __ATOMIC_ACQ_REL);
+    __atomic_fetch_add(&dev_posted, 1, __ATOMIC_RELAXED);
+    if (prev)
+        __atomic_fetch_add(&dev_coalesced, 1, __ATOMIC_RELAXED);
+    uint64_t one = 1;
+    if (write(dev_wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        perror("eventfd write");
+}
+
+static void *dev_writer_thread(void *arg)
+{
+    (void)arg;
+    int last_pattern = 0;       // main 에서 LED 를 끈 상태로 시작
+    int64_t last_write_us = 0;
+    int64_t min_gap_us = dev_max_hz > 0 ? 1000000 / dev_max_hz : 0;
+    
+    int failing = 0;
+    
+    for (;;)
     {
-        if(client_fds[i] == 0)
+        // 우편함이 비어 있을 때만 잠듦 (write 실패로 되돌려 둔 값이 있으면 바로 재시도)
+        uint64_t cnt;
+        if (!__atomic_load_n(&dev_mailbox, __ATOMIC_ACQUIRE) && read(dev_wake_fd, &cnt, sizeof(cnt)) < 0)
         {
-            client_fds[i] = fd;
-            break;
+            if (errno == EINTR)
+                continue;
+            perror("eventfd read");
+            return NULL;
+        }
+        
+        // 속도 상한: 직전 write 후 간격이 모자라면 기다렸다가 그 사이 들어온 최신값을 쓴다
+        int64_t wait_us = last_write_us + min_gap_us - now_us();
+        if (wait_us > 0)
+            usleep((useconds_t)wait_us);
+        
+        uint64_t slot = __atomic_exchange_n(&dev_mailbox, 0, __ATOMIC_ACQ_REL);
+        if (!slot)
+            continue;
+        unsigned char value = (unsigned char)(slot & 0xFF);
+        unsigned char pattern = value_to_led_pattern(value);
+        if (pattern == last_pattern)
+        {
+            __atomic_fetch_add(&dev_unchanged, 1, __ATOMIC_RELAXED);
+            continue;
         }
+        
+        int64_t recv_us = (int64_t)(slot >> 9);
+        if (sink.write(&sink, value, pattern, recv_us) < 0)
+        {
+            // last_pattern 은 그대로 두고, 그 사이 더 새 값이 없으면 이 값을 우편함에 되돌려 다시 쓴다
+            if (!failing)
+                log_msg(LOG_WARN, "LED sink write failed: %s (retrying every %d ms)\n",
+                        strerror(errno), DEV_RETRY_US / 1000);
+            failing = 1;
+            __atomic_fetch_add(&dev_failed, 1, __ATOMIC_RELAXED);
+            uint64_t empty = 0;
+            __atomic_compare_exchange_n(&dev_mailbox, &empty, slot, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            usleep(DEV_RETRY_US);
+            continue;
+        }
+        if (failing)
+            log_msg(LOG_WARN, "LED sink write recovered\n");
+        failing = 0;
+        last_pattern = pattern;
+        last_write_us = now_us();
+        hist_add_atomic(&hist_dev_write, last_write_us - recv_us);
+        __atomic_fetch_add(&dev_writes, 1, __ATOMIC_RELAXED);
     }
-    pthread_mutex_unlock(&clients_mutex);
+    return NULL;
+}
+
+void print_latency_stats(void)
+{
+    // hist_dev_write 는 writer 스레드가 갱신 중이므로 복사본으로
+    static struct lat_hist dev_write_snap;
+    hist_snapshot(&hist_dev_write, &dev_write_snap);
+    struct lat_hist *hs[] = { &dev_write_snap, &hist_notify };
+    printf("\n[TRACE] %-22s %8s %8s %8s %8s %8s\n", "stage latency (us)", "n", "p50", "p95", "p99", "max");
+    for (int i = 0; i < 2; i++)
+    {
+        struct lat_hist *h = hs[i];
+        printf("[TRACE] %-22s %8llu %8lld %8lld %8lld %8lld\n", h->name,
+               (unsigned long long)h->count,
+               (long long)hist_percentile(h, 50), (long long)hist_percentile(h, 95),
+               (long long)hist_percentile(h, 99), (long long)h->max);
+    }
+    printf("[TRACE] tcp binary frames %llu, seq lost %llu\n",
+           (unsigned long long)bin_frames, (unsigned long long)bin_lost);
+    printf("[TRACE] udp datagrams %llu, seq lost %llu, stale %llu, bad token %llu\n",
+           (unsigned long long)udp_rx, (unsigned long long)udp_lost, (unsigned long long)udp_stale,
+           (unsigned long long)udp_bad);
+    uint64_t posted = __atomic_load_n(&dev_posted, __ATOMIC_RELAXED);
+    uint64_t writes = __atomic_load_n(&dev_writes, __ATOMIC_RELAXED);
+    printf("[TRACE] %s sink values %llu, writes %llu (failed %llu), avoided %llu (coalesced %llu, unchanged pattern %llu), max %d Hz\n",
+           sink.name, (unsigned long long)posted, (unsigned long long)writes,
+           (unsigned long long)__atomic_load_n(&dev_failed, __ATOMIC_RELAXED),
+           (unsigned long long)(posted > writes ? posted - writes : 0),
+           (unsigned long long)__atomic_load_n(&dev_coalesced, __ATOMIC_RELAXED),
+           (unsigned long long)__atomic_load_n(&dev_unchanged, __ATOMIC_RELAXED), dev_max_hz);
+    printf("[TRACE] tcp led commands %llu, superseded in batch %llu\n",
+           (unsigned long long)led_cmds, (unsigned long long)led_superseded);
+    printf("[TRACE] routed msgs: directed %llu, fan-out %llu, no route %llu\n",
+           (unsigned long long)msg_directed, (unsigned long long)msg_fanout,
+           (unsigned long long)msg_noroute);
+    printf("[TRACE] state sync: snapshots %llu, led msgs sent %llu, held then sent %llu, collapsed %llu, max %d Hz\n",
+           (unsigned long long)state_snapshots, (unsigned long long)state_sent,
+           (unsigned long long)state_released, (unsigned long long)state_collapsed, update_max_hz);
+    int throttled_now = 0;
+    for (int i = 0; i < n_active; i++)
+        if (active[i]->n_led_throttled || active[i]->n_chat_throttled)
+            throttled_now++;
+    printf("[TRACE] rate limit: led deferred %llu (superseded %llu), chat dropped %llu, slowdown notices %llu, "
+           "throttled clients %d (total %llu), led %.0f/s burst %.0f, chat %.0f/s burst %.0f\n",
+           (unsigned long long)led_throttled, (unsigned long long)led_throttle_superseded,
+           (unsigned long long)chat_throttled, (unsigned long long)slowdown_sent, throttled_now,
+           (unsigned long long)throttled_clients,
+           led_limit.rate, led_limit.burst, chat_limit.rate, chat_limit.burst);
+    printf("[TRACE] tx syscalls %llu, ticks %llu (%d Hz, 0 = immediate), collapsed in tick %llu\n",
+           (unsigned long long)tx_syscalls, (unsigned long long)ticks, tick_hz,
+           (unsigned long long)tick_collapsed);
+    printf("[TRACE] tx bytes:");
+    for (int i = 0; i < MSG_CLASSES; i++)
+        printf(" %s %llu", class_names[i], (unsigned long long)tx_bytes[i]);
+    printf("\n");
+    uint64_t log_lines, log_records, log_dropped, log_sampled;
+    log_ring_stats(&log_lines, &log_records, &log_dropped, &log_sampled);
+    printf("[TRACE] log lines %llu, binary records %llu, ring full drops %llu, sampled out %llu\n",
+           (unsigned long long)log_lines, (unsigned long long)log_records,
+           (unsigned long long)log_dropped, (unsigned long long)log_sampled);
+    printf("[TRACE] clients %d, slow-consumer disconnects %llu\n",
+           n_active, (unsigned long long)slow_drops);
+    print_client_lag();
+    print_client_throttle();
+    fflush(stdout);
+}
+
+// ===== 연결 관리 =====
+static int set_nonblock(int fd)
+{
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl < 0 ? -1 : fcntl(fd, F_SETFL, fl | O_NONBLOCK);
+}
+
+static void epoll_set(int fd, int64_t tag, uint32_t events, int op)
+{
+    struct epoll_event ev = { .events = events, .data.u64 = (uint64_t)tag };
+    if (epoll_ctl(epfd, op, fd, &ev) < 0)
+        perror("epoll_ctl");
+}
+
+// 클라이언트 추가
+struct conn *add_client(int fd)
+{
+    if (n_active >= MAX_CLIENTS)
+        return NULL;
+    if (fd >= conns_cap)
+    {
+        int cap = conns_cap ? conns_cap : 64;
+        while (cap <= fd) cap *= 2;
+        struct conn **p = realloc(conns, cap * sizeof(*p));
+        if (!p)
+            return NULL;
+        memset(p + conns_cap, 0, (cap - conns_cap) * sizeof(*p));
+        conns = p;
+        conns_cap = cap;
+    }
+    struct conn *c = calloc(1, sizeof(*c));
+    if (!c)
+        return NULL;
+    c->fd = fd;
+    c->last_seq = -1;
+    c->udp_last_seq = -1;
+    int64_t now = now_us();
+    c->led_bucket = (struct token_bucket){ led_limit.burst, now };
+    c->chat_bucket = (struct token_bucket){ chat_limit.burst, now };
+    strcpy(c->id, "Unknown");
+    c->idx = n_active;
+    active[n_active++] = c;
+    conns[fd] = c;
+    return c;
+}
+
+// ===== id -> 연결 인덱스 =====
+static unsigned id_hash(const char *id)
+{
+    unsigned h = 2166136261u;   // FNV-1a
+    while (*id)
+        h = (h ^ (uint8_t)*id++) * 16777619u;
+    return h & (ID_BUCKETS - 1);
+}
+
+static void id_index_add(struct conn *c)
+{
+    unsigned h = id_hash(c->id);
+    c->id_next = id_index[h];
+    id_index[h] = c;
+    c->indexed = 1;
+}
+
+static void id_index_del(struct conn *c)
+{
+    if (!c->indexed)
+        return;
+    struct conn **pp = &id_index[id_hash(c->id)];
+    while (*pp && *pp != c)
+        pp = &(*pp)->id_next;
+    if (*pp)
+        *pp = c->id_next;
+    c->indexed = 0;
+}
+
+// 로그인해 있는 id 인지 (주소 판별용)
+static int id_logged_in(const char *id)
+{
+    for (struct conn *t = id_index[id_hash(id)]; t; t = t->id_next)
+    {
+        if (!t->dead && strcmp(t->id, id) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+// ===== UDP 토큰 -> 연결 인덱스 =====
+static struct conn *token_find(uint32_t token)
+{
+    for (struct conn *t = token_index[token & (TOKEN_BUCKETS - 1)]; t; t = t->token_next)
+    {
+        if (t->token == token)
+            return t;
+    }
+    return NULL;
+}
+
+static void token_index_add(struct conn *c)
+{
+    struct conn **head = &token_index[c->token & (TOKEN_BUCKETS - 1)];
+    c->token_next = *head;
+    *head = c;
+}
+
+static void token_index_del(struct conn *c)
+{
+    if (!c->token)
+        return;
+    struct conn **pp = &token_index[c->token & (TOKEN_BUCKETS - 1)];
+    while (*pp && *pp != c)
+        pp = &(*pp)->token_next;
+    if (*pp)
+        *pp = c->token_next;
+    c->token = 0;
 }
 
 // 클라이언트 제거
-void remove_client(int fd)
+void remove_client(struct conn *c)
 {
-    pthread_mutex_lock(&clients_mutex);
-    for(int i = 0; i < MAX_CLIENTS; i++)
+    log_msg(LOG_INFO, "Client disconnected (FD: %d, ID: %s)\n", c->fd, c->id);
+    id_index_del(c);
+    token_index_del(c);
+    n_held -= (c->held_len[0] != 0) + (c->held_len[1] != 0);
+    if (c->deferred.pending)
+        n_deferred--;
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    active[c->idx] = active[--n_active];
+    active[c->idx]->idx = c->idx;
+    conns[c->fd] = NULL;
+    free(c->out);
+    free(c);
+}
+
+// 이벤트 처리 중 dead 로 표시된 연결 정리 (브로드캐스트 순회 중에는 배열을 건드리지 않음)
+static void reap_dead(void)
+{
+    for (int i = n_active - 1; i >= 0; i--)
     {
-        if(client_fds[i] == fd)
+        if (active[i]->dead)
+            remove_client(active[i]);
+    }
+}
+
+// 송신 버퍼 뒤에 덧붙임 (공간 부족하면 앞쪽 보낸 부분을 당기고, 그래도 부족하면 키움)
+static int out_append(struct conn *c, const void *data, size_t len)
+{
+    if (c->out_len + len > c->out_cap)
+    {
+        memmove(c->out, c->out + c->out_off, c->out_len - c->out_off);
+        c->out_len -= c->out_off;
+        c->out_off = 0;
+        if (c->out_len + len > c->out_cap)
+        {
+            size_t cap = c->out_cap ? c->out_cap : 4096;
+            while (cap < c->out_len + len) cap *= 2;
+            char *p = realloc(c->out, cap);
+            if (!p)
+                return -1;
+            c->out = p;
+            c->out_cap = cap;
+        }
+    }
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+    // tick 을 기다리며 쌓인 것은 밀림이 아님
+    if (c->backlog_since && c->out_len - c->out_off > c->backlog_max)
+        c->backlog_max = c->out_len - c->out_off;
+    return 0;
+}
+
+// 송신 대기 버퍼 비우기. 비면 합쳐 둔 최신 LED 메시지를 이어 보내고, 모두 비면 EPOLLOUT 해제
+static void conn_flush(struct conn *c)
+{
+    for (;;)
+    {
+        while (c->out_off < c->out_len)
+        {
+            ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+            tx_syscalls++;
+            if (n > 0)
+            {
+                c->out_off += n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return;
+            c->dead = 1;
+            return;
+        }
+        c->out_off = c->out_len = 0;
+        
+        int more = 0;
+        for (int k = 0; k < 2; k++)
         {
-            client_fds[i] = 0;
+            if (c->pend_len[k])
+            {
+                if (out_append(c, c->pend[k], c->pend_len[k]) < 0)
+                {
+                    c->dead = 1;
+                    return;
+                }
+                c->pend_len[k] = 0;
+                more = 1;
+            }
+        }
+        if (!more)
             break;
+    }
+    c->backlog_since = 0;
+    epoll_set(c->fd, c->fd, EPOLLIN, EPOLL_CTL_MOD);
+}
+
+// 비블로킹 송신: 바로 못 보낸 나머지는 연결별 버퍼에 쌓고 EPOLLOUT 으로 마저 보냄.
+// 이미 밀려 있으면 메시지 종류별 정책(coalesce/drop/disconnect)을 따른다
+void conn_send(struct conn *c, const void *data, size_t len, int cls)
+{
+    if (c->dead || len == 0)
+        return;
+    int policy = class_policy[cls];
+    tx_bytes[cls] += len;
+    
+    // tick 모드에서는 서버 응답만 바로 보내고 나머지는 다음 tick 에 모아서 보냄
+    if (c->out_len == c->out_off && (!tick_hz || cls == MSG_CTRL))
+    {
+        ssize_t n = send(c->fd, data, len, MSG_NOSIGNAL);
+        tx_syscalls++;
+        if (n == (ssize_t)len)
+            return;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            c->dead = 1;
+            return;
         }
+        // 일부만 나간 메시지는 정책과 무관하게 나머지를 보내야 스트림이 깨지지 않음
+        if (n < 0)
+            n = 0;
+        c->backlog_since = now_us();
+        epoll_set(c->fd, c->fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+        if (out_append(c, (const char *)data + n, len - n) < 0)
+            c->dead = 1;
+        return;
+    }
+    
+    // 밀려 있는 동안(또는 tick 을 기다리는 동안) LED 상태는 최신 하나만 유지
+    if (policy == POLICY_COALESCE && (cls == MSG_LED_CMD || cls == MSG_LED_UPDATE) && len <= PEND_MAX)
+    {
+        int k = cls == MSG_LED_CMD ? 0 : 1;
+        if (c->pend_len[k] && c->backlog_since)
+            c->n_coalesced++;
+        else if (c->pend_len[k])
+            tick_collapsed++;
+        tx_bytes[cls] -= c->pend_len[k];    // 덮인 메시지는 나가지 않음
+        memcpy(c->pend[k], data, len);
+        c->pend_len[k] = (uint8_t)len;
+        return;
     }
-    pthread_mutex_unlock(&clients_mutex);
+    
+    if (c->out_len - c->out_off + len > outbuf_limit)
+    {
+        if (policy == POLICY_DISCONNECT)
+        {
+            log_msg(LOG_WARN, "Slow client (FD: %d, ID: %s, %s backlog %zu bytes), disconnecting\n",
+                   c->fd, c->id, class_names[cls], c->out_len - c->out_off);
+            slow_drops++;
+            c->dead = 1;
+        }
+        else
+        {
+            c->n_dropped++;
+        }
+        return;
+    }
+    if (out_append(c, data, len) < 0)
+        c->dead = 1;
 }
 
-// 모든 클라이언트에게 브로드캐스트
-void broadcast_to_all(char *message, int sender_fd)
+// tick 모드: 모아 둔 송신 버퍼와 최신 LED 메시지를 writev 한 번으로 보냄.
+// 다 못 보낸 나머지는 송신 버퍼에 남기고 EPOLLOUT 으로 마저 보냄 (conn_flush)
+static void tick_flush(struct conn *c)
 {
-    pthread_mutex_lock(&clients_mutex);
-    for(int i = 0; i < MAX_CLIENTS; i++)
+    struct iovec iov[3];
+    int cnt = 0;
+    size_t queued = c->out_len - c->out_off;
+    if (queued)
+        iov[cnt++] = (struct iovec){ c->out + c->out_off, queued };
+    for (int k = 0; k < 2; k++)
+        if (c->pend_len[k])
+            iov[cnt++] = (struct iovec){ c->pend[k], c->pend_len[k] };
+    if (cnt == 0)
+        return;
+    
+    ssize_t n = writev(c->fd, iov, cnt);
+    tx_syscalls++;
+    if (n < 0)
     {
-        if(client_fds[i] != 0 && client_fds[i] != sender_fd)
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
         {
-            write(client_fds[i], message, strlen(message));
+            c->dead = 1;
+            return;
         }
+        n = 0;
+    }
+    
+    size_t sent = (size_t)n;
+    if (sent < queued)
+    {
+        c->out_off += sent;
+    }
+    else
+    {
+        sent -= queued;
+        c->out_off = c->out_len = 0;
+        for (int k = 0; k < 2; k++)
+        {
+            if (!c->pend_len[k])
+                continue;
+            if (sent < c->pend_len[k])
+            {
+                // 일부만 나간 LED 메시지는 나머지를 송신 버퍼로 (뒤 메시지는 pend 에 남아 순서 유지)
+                if (out_append(c, c->pend[k] + sent, c->pend_len[k] - sent) < 0)
+                    c->dead = 1;
+                c->pend_len[k] = 0;
+                break;
+            }
+            sent -= c->pend_len[k];
+            c->pend_len[k] = 0;
+        }
+    }
+    
+    if (c->out_len > c->out_off || c->pend_len[0] || c->pend_len[1])
+    {
+        c->backlog_since = now_us();
+        epoll_set(c->fd, c->fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+    }
+}
+
+// timerfd tick: 밀려서 EPOLLOUT 을 기다리는 연결을 뺀 모든 연결을 flush 하고 알림 지연 기록
+static void on_tick(int tick_fd)
+{
+    uint64_t expirations;
+    if (read(tick_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return;
+    ticks++;
+    for (int i = 0; i < n_active; i++)
+    {
+        struct conn *c = active[i];
+        if (!c->dead && !c->backlog_since)
+            tick_flush(c);
+    }
+    int64_t now = now_us();
+    for (int i = 0; i < n_tick_recv; i++)
+        hist_add(&hist_notify, now - tick_recv_us[i]);
+    n_tick_recv = 0;
+}
+
+// 연결별 지연 지표 (밀린 적이 있는 연결만)
+void print_client_lag(void)
+{
+    int64_t now = now_us();
+    int shown = 0;
+    for (int i = 0; i < n_active && shown < 20; i++)
+    {
+        struct conn *c = active[i];
+        if (!c->backlog_max && !c->n_dropped && !c->n_coalesced)
+            continue;
+        printf("[LAG] FD %-4d %-12s backlog %7zu B (max %7zu) lag %6lld ms dropped %llu coalesced %llu\n",
+               c->fd, c->id, c->out_len - c->out_off, c->backlog_max,
+               c->backlog_since ? (long long)(now - c->backlog_since) / 1000 : 0LL,
+               (unsigned long long)c->n_dropped, (unsigned long long)c->n_coalesced);
+        shown++;
     }
-    pthread_mutex_unlock(&clients_mutex);
 }
 
-// 모든 클라이언트에게 전송 (발신자 포함)
-void send_to_all(char *message)
+// 속도 제한에 걸린 적 있는 연결
+void print_client_throttle(void)
 {
-    pthread_mutex_lock(&clients_mutex);
-    for(int i = 0; i < MAX_CLIENTS; i++)
+    int shown = 0;
+    for (int i = 0; i < n_active && shown < 20; i++)
     {
-        if(client_fds[i] != 0)
+        struct conn *c = active[i];
+        if (!c->n_led_throttled && !c->n_chat_throttled)
+            continue;
+        printf("[THROTTLE] FD %-4d %-12s led deferred %llu chat dropped %llu%s\n",
+               c->fd, c->id, (unsigned long long)c->n_led_throttled,
+               (unsigned long long)c->n_chat_throttled, c->deferred.pending ? " (led pending)" : "");
+        shown++;
+    }
+}
+
+// 토큰 하나 꺼냄. 반환: 1 = 통과, 0 = 토큰 없음
+static int bucket_take(struct token_bucket *b, const struct rate_limit *r, int64_t now)
+{
+    if (r->rate <= 0)
+        return 1;
+    b->tokens += (double)(now - b->last_us) * r->rate / 1e6;
+    if (b->tokens > r->burst)
+        b->tokens = r->burst;
+    b->last_us = now;
+    if (b->tokens < 1.0)
+        return 0;
+    b->tokens -= 1.0;
+    return 1;
+}
+
+// 다음 토큰까지 남은 시간 (us)
+static int64_t bucket_wait_us(const struct token_bucket *b, const struct rate_limit *r, int64_t now)
+{
+    double tokens = b->tokens + (double)(now - b->last_us) * r->rate / 1e6;
+    if (tokens >= 1.0)
+        return 0;
+    return (int64_t)((1.0 - tokens) * 1e6 / r->rate) + 1;
+}
+
+// UDP 토큰 생성 (0 은 "없음" 으로 예약)
+static uint32_t make_token(int fd)
+{
+    uint32_t t = 0;
+    int rfd = open("/dev/urandom", O_RDONLY);
+    if (rfd >= 0)
+    {
+        if (read(rfd, &t, sizeof(t)) != sizeof(t))
+            t = 0;
+        close(rfd);
+    }
+    if (t == 0)
+        t = (uint32_t)now_us() ^ ((uint32_t)fd << 24) ^ 0x5a5a5a5a;
+    return t ? t : 1;
+}
+
+// 모든 클라이언트에게 브로드캐스트
+void broadcast_to_all(const char *message, struct conn *sender)
+{
+    size_t len = strlen(message);
+    for (int i = 0; i < n_active; i++)
+    {
+        if (active[i] != sender && active[i]->logged_in)
+            conn_send(active[i], message, len, MSG_CHAT);
+    }
+}
+
+// LED 상태 메시지(MSG_LED_CMD / MSG_LED_UPDATE) 전송. 연결에 속도 상한이 있으면
+// 다음 전송 시각까지 종류별 최신 하나만 보류했다가 release_held_state() 가 보냄
+static void conn_send_state(struct conn *c, const void *msg, size_t len, int cls, int64_t now)
+{
+    int k = cls == MSG_LED_CMD ? 0 : 1;
+    if (c->state_interval_us && now < c->next_state_us[k] && len <= PEND_MAX)
+    {
+        if (c->held_len[k])
+            state_collapsed++;
+        else
+            n_held++;
+        memcpy(c->held[k], msg, len);
+        c->held_len[k] = (uint8_t)len;
+        return;
+    }
+    // 보류분보다 새 상태이므로 보류분은 버림
+    if (c->held_len[k])
+    {
+        c->held_len[k] = 0;
+        n_held--;
+        state_collapsed++;
+    }
+    c->next_state_us[k] = now + c->state_interval_us;
+    state_sent++;
+    conn_send(c, msg, len, cls);
+}
+
+// LED 명령/알림 전달 (발신자 제외, NULL 이면 전체): 텍스트 클라이언트에는 text, 바이너리 클라이언트에는 frame
+void broadcast_led(const char *text, const uint8_t *frame, struct conn *sender, int cls)
+{
+    size_t len = strlen(text);
+    int64_t now = now_us();
+    for (int i = 0; i < n_active; i++)
+    {
+        struct conn *c = active[i];
+        if (c == sender || !c->logged_in)
+            continue;
+        if (c->binary)
+            conn_send_state(c, frame, LED_FRAME_SIZE, cls, now);
+        else
+            conn_send_state(c, text, len, cls, now);
+    }
+}
+
+// 메시지 앞의 받는 사람 id: "[id]..." 또는 "id:..." (NetClient). 없으면 0
+static int parse_route(const char *msg, char *to)
+{
+    const char *p = msg;
+    char end = ':';
+    if (*p == '[')
+    {
+        p++;
+        end = ']';
+    }
+    int len = 0;
+    while (p[len] && p[len] != end && len < ID_LEN - 1)
+    {
+        char ch = p[len];
+        if (!(isalnum((unsigned char)ch) || ch == '_' || ch == '-'))
+            return 0;
+        len++;
+    }
+    if (len == 0 || p[len] != end)
+        return 0;
+    memcpy(to, p, len);
+    to[len] = '\0';
+    return 1;
+}
+
+// 앞의 "[id]"/"id:" 가 로그인해 있는 id 면 그 연결에만, 그 외("[ALLMSG]", 주소 없음,
+// "[KSH_QT]LED@.." 처럼 id 가 아닌 태그, "note: hi" 같은 일반 문장)는 전체(발신자 제외)로.
+// frame 이 있으면(LED 명령) 바이너리 연결에는 프레임으로 보낸다
+void route_message(const char *text, const uint8_t *frame, struct conn *sender, int cls)
+{
+    char to[ID_LEN];
+    if (!parse_route(text, to) || strcmp(to, "ALLMSG") == 0 || !id_logged_in(to))
+    {
+        msg_fanout++;
+        if (frame)
+            broadcast_led(text, frame, sender, cls);
+        else
+            broadcast_to_all(text, sender);
+        return;
+    }
+    
+    int hit = 0;
+    size_t len = strlen(text);
+    for (struct conn *t = id_index[id_hash(to)]; t; t = t->id_next)
+    {
+        if (t == sender || t->dead || strcmp(t->id, to) != 0)
+            continue;
+        if (frame && t->binary)
+            conn_send_state(t, frame, LED_FRAME_SIZE, cls, now_us());
+        else if (frame)
+            conn_send_state(t, text, len, cls, now_us());
+        else
+            conn_send(t, text, len, cls);
+        hit++;
+    }
+    if (hit)
+        msg_directed++;
+    else
+        msg_noroute++;
+}
+
+// 보류한 LED 상태 메시지 중 전송 시각이 된 것을 보냄. 반환: 다음 전송까지 남은 ms (-1 = 보류 없음)
+static int release_held_state(void)
+{
+    if (!n_held)
+        return -1;
+    int64_t now = now_us();
+    int64_t next = INT64_MAX;
+    for (int i = 0; i < n_active; i++)
+    {
+        struct conn *c = active[i];
+        for (int k = 0; k < 2; k++)
         {
-            write(client_fds[i], message, strlen(message));
+            if (!c->held_len[k])
+                continue;
+            if (now >= c->next_state_us[k])
+            {
+                c->next_state_us[k] = now + c->state_interval_us;
+                state_sent++;
+                state_released++;
+                conn_send(c, c->held[k], c->held_len[k], k == 0 ? MSG_LED_CMD : MSG_LED_UPDATE);
+                c->held_len[k] = 0;
+                n_held--;
+            }
+            else if (c->next_state_us[k] < next)
+            {
+                next = c->next_state_us[k];
+            }
         }
     }
-    pthread_mutex_unlock(&clients_mutex);
+    if (next == INT64_MAX)
+        return -1;
+    return (int)((next - now + 999) / 1000);
+}
+
+// LED 반영 알림 (발신자 포함). 바이너리 클라이언트에는 원 명령의 seq/ts 를 되돌려준다
+void send_led_update(unsigned char value, uint16_t seq, uint64_t ts_us)
+{
+    char notify[100];
+    snprintf(notify, sizeof(notify), "[SERVER]LED_UPDATE@0x%02x\n", value);
+    struct led_frame f = { .type = LED_FRAME_UPDATE, .value = value, .seq = seq, .ts_us = ts_us };
+    uint8_t frame[LED_FRAME_SIZE];
+    led_frame_encode(&f, frame);
+    broadcast_led(notify, frame, NULL, MSG_LED_UPDATE);
+}
+
+// 로그인 직후 현재 LED 상태를 보냄 (다음 LED 명령을 기다리지 않고 화면을 맞춤).
+// 명령에 대한 응답(LED_UPDATE)과 구분되게 텍스트는 "LED_STATE@", 프레임은 LED_FLAG_SNAPSHOT
+static void send_state_snapshot(struct conn *c)
+{
+    if (c->binary)
+    {
+        struct led_frame f = { .type = LED_FRAME_UPDATE, .value = led_state.value, .flags = LED_FLAG_SNAPSHOT,
+                               .seq = led_state.seq, .ts_us = led_state.ts_us };
+        uint8_t frame[LED_FRAME_SIZE];
+        led_frame_encode(&f, frame);
+        conn_send(c, frame, LED_FRAME_SIZE, MSG_LED_UPDATE);
+    }
+    else
+    {
+        char notify[100];
+        int len = snprintf(notify, sizeof(notify), "[SERVER]LED_STATE@0x%02x\n", led_state.value);
+        conn_send(c, notify, len, MSG_LED_UPDATE);
+    }
+    c->next_state_us[1] = now_us() + c->state_interval_us;
+    state_snapshots++;
 }
 
 unsigned char value_to_led_pattern(unsigned char value)
@@ -110,158 +1012,582 @@ unsigned char value_to_led_pattern(unsigned char value)
     return pattern;
 }
 
+// LED 상태 한 줄 (문자열을 만들어 로그 한 번으로)
 void print_led_status(unsigned char value, unsigned char pattern)
 {
     int i;
     int led_count = 0;
+    char bar[16];
     
     for (i = 0; i < 8; i++) {
         if (pattern & (1 << i)) led_count++;
     }
     
-    printf("Value: %3d (0x%02X) -> %d LEDs: [", value, value, led_count);
-    
     for (i = 7; i >= 0; i--)
     {
-        if (pattern & (0x01 << i))
-            printf("O");
-        else
-            printf("X");
-        if (i > 0)
-            printf(" ");
+        bar[(7 - i) * 2] = (pattern & (0x01 << i)) ? 'O' : 'X';
+        bar[(7 - i) * 2 + 1] = ' ';
     }
-    printf("]\n");
+    bar[15] = '\0';
+    log_msg(LOG_INFO, "Value: %3d (0x%02X) -> %d LEDs: [%s]\n", value, value, led_count, bar);
 }
 
-void *handle_client(void *arg)
+// LED 값 반영: 패턴 변환 -> writer 스레드에 전달 -> 알림. show = 로그 샘플링에 걸린 명령
+void apply_led(unsigned char dial_value, uint16_t seq, uint64_t ts_us, int64_t recv_us, int show)
 {
-    int client_fd = *(int*)arg;
-    char buffer[BUFFER_SIZE] = {0};
-    char client_id[50] = "Unknown";
-    int n;
+    unsigned char led_pattern = value_to_led_pattern(dial_value);
+    if (show)
+        print_led_status(dial_value, led_pattern);
     
-    printf("Client connected (FD: %d)\n", client_fd);
-    add_client(client_fd);
+    // LED sink 에 쓰기 (writer 스레드가 최신값만, 패턴이 바뀔 때만, 속도 상한 안에서)
+    dev_post(dial_value, recv_us);
     
-    // 로그인 정보 수신
-    n = read(client_fd, buffer, BUFFER_SIZE);
-    if (n > 0)
+    // 현재 상태 갱신 후 모든 클라이언트에게 알림 (sink 종류와 무관)
+    led_state = (struct led_state){ .value = dial_value, .seq = seq, .ts_us = ts_us };
+    send_led_update(dial_value, seq, ts_us);
+    if (!tick_hz)
+        hist_add(&hist_notify, now_us() - recv_us);
+    else if (n_tick_recv < TICK_LAT_MAX)
+        tick_recv_us[n_tick_recv++] = recv_us;
+}
+
+// 텍스트 메시지(한 줄) 처리. LED 명령은 묶음에 기록만 하고 led_batch_flush() 에서 반영
+void handle_text_message(struct conn *c, char *buffer, struct led_batch *batch)
+{
+    // LED 데이터 처리 (고빈도: 로그 샘플링 / 바이너리 로그)
+    if (strstr(buffer, "LED@"))
     {
-        buffer[n] = '\0';
-        printf("Login info from FD %d: %s\n", client_fd, buffer);
+        char *led_str = strstr(buffer, "LED@");
+        led_str += 4;
         
-        // 클라이언트 ID 추출
-        if(buffer[0] == '[')
+        unsigned char dial_value = 0;
+        if (strncmp(led_str, "0x", 2) == 0)
+        {
+            dial_value = (unsigned char)strtoul(led_str, NULL, 16);
+        }
+        else
+        {
+            dial_value = (unsigned char)atoi(led_str);
+        }
+        
+        int show = log_hot(LOG_EV_LED_TEXT, c->fd, dial_value, 0);
+        if (show)
+            log_msg(LOG_INFO, "\n[FROM %s(FD:%d)]: %s", c->id, c->fd, buffer);
+        
+        led_cmds++;
+        if (batch->pending)
+            led_superseded++;
+        batch->pending = 1;
+        batch->binary = 0;
+        batch->udp = 0;
+        batch->show = show;
+        batch->f = (struct led_frame){ .type = LED_FRAME_SET, .value = dial_value };
+        snprintf(batch->text, sizeof(batch->text), "%s", buffer);
+    }
+    // 일반 메시지 처리: 받는 사람에게만, [ALLMSG] 는 모든 클라이언트에게
+    else
+    {
+        if (!bucket_take(&c->chat_bucket, &chat_limit, now_us()))
         {
-            char *end = strchr(buffer, ':');
-            if(!end) end = strchr(buffer, ']');
-            if(end)
+            chat_throttled++;
+            if (!c->n_led_throttled && !c->n_chat_throttled)
+                throttled_clients++;
+            c->n_chat_throttled++;
+            return;
+        }
+        log_msg(LOG_INFO, "\n[FROM %s(FD:%d)]: %s", c->id, c->fd, buffer);
+        route_message(buffer, NULL, c, MSG_CHAT);
+        if (strncmp(buffer, "[ALLMSG]", 8) == 0)
+            log_msg(LOG_DEBUG, "Broadcasting message to all clients\n");
+    }
+}
+
+// seq 손실 집계 (TCP / UDP 각자의 lost 카운터). 직전보다 새 프레임이면 1, 역순/중복이면 0 (last_seq 유지)
+int seq_account(int *last_seq, uint16_t seq, uint64_t *lost)
+{
+    int newer = 1;
+    if (*last_seq >= 0)
+    {
+        uint16_t gap = (uint16_t)(seq - (uint16_t)*last_seq - 1);
+        if (gap < 0x8000)
+            *lost += gap;
+        else
+            newer = 0;
+    }
+    if (newer)
+        *last_seq = seq;
+    return newer;
+}
+
+// 바이너리 프레임 처리
+void handle_led_frame(struct conn *c, const char *via, const uint8_t *raw,
+                      const struct led_frame *f, int64_t recv_us)
+{
+    if (f->type != LED_FRAME_SET)
+        return;
+    
+    int show = log_hot(strcmp(via, "UDP") == 0 ? LOG_EV_LED_UDP : LOG_EV_LED_FRAME,
+                       c->fd, f->value, f->seq);
+    if (show)
+        log_msg(LOG_INFO, "\n[FROM %s(FD:%d)]: <BIN LED@0x%02x seq=%u>\n", via, c->fd, f->value, f->seq);
+    
+    char text[32];
+    snprintf(text, sizeof(text), "LED@0x%02x\n", f->value);
+    broadcast_led(text, raw, c, MSG_LED_CMD);
+    
+    apply_led(f->value, f->seq, f->ts_us, recv_us, show);
+}
+
+// 묶음의 마지막 LED 명령을 다른 클라이언트에 전달하고 디바이스에 반영
+static void led_batch_apply(struct conn *c, const struct led_batch *batch, int64_t recv_us)
+{
+    if (batch->binary)
+    {
+        handle_led_frame(c, batch->udp ? "UDP" : c->id, batch->raw, &batch->f, recv_us);
+        return;
+    }
+    // 받는 사람(주소 없으면 전체)에게 전달 (바이너리 클라이언트는 프레임으로)
+    uint8_t frame[LED_FRAME_SIZE];
+    led_frame_encode(&batch->f, frame);
+    route_message(batch->text, frame, c, MSG_LED_CMD);
+    
+    apply_led(batch->f.value, 0, 0, recv_us, batch->show);
+}
+
+// 속도 제한에 걸린 클라이언트에 "[SERVER]SLOWDOWN@<hz>" 알림 (SLOWDOWN_INTERVAL_US 마다 한 번)
+static void send_slowdown(struct conn *c, int64_t now)
+{
+    if (c->slowdown_sent_us && now - c->slowdown_sent_us < SLOWDOWN_INTERVAL_US)
+        return;
+    c->slowdown_sent_us = now;
+    char msg[48];
+    int len = snprintf(msg, sizeof(msg), "[SERVER]SLOWDOWN@%d\n", (int)led_limit.rate);
+    conn_send(c, msg, len, MSG_CTRL);
+    slowdown_sent++;
+    log_msg(LOG_WARN, "LED rate limit: FD %d (ID: %s) asked to slow down to %d Hz\n",
+            c->fd, c->id, (int)led_limit.rate);
+}
+
+// LED 명령 반영. 토큰이 없으면 최신 명령 하나만 보류했다가 release_deferred_led() 가 반영
+static void led_batch_flush(struct conn *c, struct led_batch *batch, int64_t recv_us)
+{
+    if (!batch->pending)
+        return;
+    batch->pending = 0;
+    int64_t now = now_us();
+    if (!bucket_take(&c->led_bucket, &led_limit, now))
+    {
+        if (c->deferred.pending)
+            led_throttle_superseded++;
+        else
+            n_deferred++;
+        c->deferred = *batch;
+        c->deferred.pending = 1;
+        c->deferred_recv_us = recv_us;
+        if (!c->n_chat_throttled && !c->n_led_throttled)
+            throttled_clients++;
+        c->n_led_throttled++;
+        led_throttled++;
+        send_slowdown(c, now);
+        return;
+    }
+    // 보류분보다 새 명령이므로 보류분은 버림
+    if (c->deferred.pending)
+    {
+        c->deferred.pending = 0;
+        n_deferred--;
+        led_throttle_superseded++;
+    }
+    led_batch_apply(c, batch, recv_us);
+}
+
+// 보류한 LED 명령 중 토큰이 찬 것을 반영. 반환: 다음 토큰까지 남은 ms (-1 = 보류 없음)
+static int release_deferred_led(void)
+{
+    if (!n_deferred)
+        return -1;
+    int64_t now = now_us();
+    int64_t wait = INT64_MAX;
+    for (int i = 0; i < n_active; i++)
+    {
+        struct conn *c = active[i];
+        if (!c->deferred.pending || c->dead)
+            continue;
+        if (bucket_take(&c->led_bucket, &led_limit, now))
+        {
+            c->deferred.pending = 0;
+            n_deferred--;
+            led_batch_apply(c, &c->deferred, c->deferred_recv_us);
+        }
+        else
+        {
+            int64_t w = bucket_wait_us(&c->led_bucket, &led_limit, now);
+            if (w < wait)
+                wait = w;
+        }
+    }
+    if (wait == INT64_MAX)
+        return -1;
+    return (int)((wait + 999) / 1000);
+}
+
+// 로그인 정보 처리 (연결 후 첫 메시지)
+static void handle_login(struct conn *c, char *buffer)
+{
+    log_msg(LOG_INFO, "Login info from FD %d: %s\n", c->fd, buffer);
+    
+    // 클라이언트 ID 추출: "[id:pw]" / "[id]" / "id:pw"
+    int skip = buffer[0] == '[' ? 1 : 0;
+    char *end = strchr(buffer, ':');
+    if(!end && skip) end = strchr(buffer, ']');
+    if(end)
+    {
+        int len = end - buffer - skip;
+        if(len > 0 && len < ID_LEN - 1)
+        {
+            memcpy(c->id, buffer + skip, len);
+            c->id[len] = '\0';
+            id_index_add(c);
+        }
+    }
+    
+    c->logged_in = 1;
+    // "id:pw:BIN1" / "[id:pw:BIN1]" 이면 바이너리 프레임 사용 + UDP 토큰 발급
+    if (strstr(buffer, ":" LED_PROTO_BIN_TAG))
+    {
+        c->binary = 1;
+        do
+            c->token = make_token(c->fd);
+        while (token_find(c->token));
+        token_index_add(c);
+        char reply[64];
+        int len = snprintf(reply, sizeof(reply), "[SERVER]Connected " LED_PROTO_BIN_TAG " " LED_UDP_TAG "%08x\n", c->token);
+        conn_send(c, reply, len, MSG_CTRL);
+    }
+    else
+    {
+        conn_send(c, "[SERVER]Connected\n", 18, MSG_CTRL);
+    }
+    
+    // 구독 속도: "...:HZ30" 이면 초당 30 번까지. 서버 상한(--update-max-hz=)보다 빠를 수는 없음
+    int hz = update_max_hz;
+    const char *tag = strstr(buffer, LOGIN_HZ_TAG);
+    if (tag)
+    {
+        int want = atoi(tag + strlen(LOGIN_HZ_TAG));
+        if (want > 0 && (hz == 0 || want < hz))
+            hz = want;
+    }
+    c->state_interval_us = hz > 0 ? 1000000 / hz : 0;
+    send_state_snapshot(c);
+}
+
+// 로그인 메시지 길이. Qt 는 "[id:pw]", NetClient 는 "id:pw\n" 으로 보낸다.
+// "[...]" 는 ']' 까지 (없으면 더 기다림), "id:pw" 는 첫 '\n' 까지.
+// 개행 없이 보내던 이전 클라이언트는 그 read 전체가 로그인이다 (내용으로 추측해 자르지 않음)
+static int login_frame_len(const char *buf, int n)
+{
+    if (buf[0] == '[')
+    {
+        const char *end = memchr(buf, ']', n);
+        if (end)
+            return (int)(end - buf) + 1;
+        return n < BUFFER_SIZE - 1 ? 0 : n;
+    }
+    const char *nl = memchr(buf, '\n', n);
+    return nl ? (int)(nl - buf) + 1 : n;
+}
+
+// 수신 버퍼 [0, n) 처리. TCP 는 메시지 경계가 없으므로 완성된 줄/프레임을 모두 꺼내
+// 한 묶음으로 처리하고, 잘린 나머지는 다음 read 앞에 남긴다.
+// 묶음 안의 LED 명령은 마지막 값만 디바이스에 반영한다
+static void conn_consume(struct conn *c, int n, int64_t recv_us)
+{
+    char *buffer = c->in;
+    struct led_batch batch;
+    char line[BUFFER_SIZE];
+    int pos = 0;
+    batch.pending = 0;
+    
+    if (!c->logged_in)
+    {
+        int len = login_frame_len(buffer, n);
+        if (len == 0)
+        {
+            c->in_len = n;
+            return;
+        }
+        memcpy(line, buffer, len);
+        line[len] = '\0';
+        if (line[len - 1] == '\n')
+            line[len - 1] = '\0';
+        handle_login(c, line);
+        pos = len;
+    }
+    
+    while (pos < n && !c->dead)
+    {
+        // 바이너리 연결: 첫 바이트 0xA5 면 프레임
+        if (c->binary && (uint8_t)buffer[pos] == LED_FRAME_MAGIC0)
+        {
+            struct led_frame f;
+            int r = led_frame_decode((uint8_t *)buffer + pos, n - pos, &f);
+            if (r == 0)
+                break;
+            if (r > 0)
             {
-                int len = end - buffer - 1;
-                if(len > 0 && len < 49)
+                bin_frames++;
+                seq_account(&c->last_seq, f.seq, &bin_lost);
+                if (f.type == LED_FRAME_SET)
                 {
-                    strncpy(client_id, buffer + 1, len);
-                    client_id[len] = '\0';
+                    led_cmds++;
+                    if (batch.pending)
+                        led_superseded++;
+                    batch.pending = 1;
+                    batch.binary = 1;
+                    batch.udp = 0;
+                    batch.f = f;
+                    memcpy(batch.raw, buffer + pos, LED_FRAME_SIZE);
                 }
+                pos += r;
+                continue;
             }
         }
         
-        write(client_fd, "[SERVER]Connected\n", 18);
+        // 텍스트: '\n' 까지 한 줄. 버퍼가 가득 찼는데 개행이 없으면 그대로 한 메시지로 처리
+        const char *nl = memchr(buffer + pos, '\n', n - pos);
+        int len;
+        if (nl)
+            len = (int)(nl - (buffer + pos)) + 1;
+        else if (pos == 0 && n == BUFFER_SIZE - 1)
+            len = n;
+        else
+            break;
+        memcpy(line, buffer + pos, len);
+        line[len] = '\0';
+        handle_text_message(c, line, &batch);
+        pos += len;
     }
     
-    while (1)
+    c->in_len = n - pos;
+    if (c->in_len > 0 && pos > 0)
+        memmove(buffer, buffer + pos, c->in_len);
+    led_batch_flush(c, &batch, recv_us);
+}
+
+// 클라이언트 수신 (레벨 트리거)
+static void on_client_readable(struct conn *c)
+{
+    int n = read(c->fd, c->in + c->in_len, BUFFER_SIZE - 1 - c->in_len);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+    if (n <= 0)
+    {
+        c->dead = 1;
+        return;
+    }
+    conn_consume(c, c->in_len + n, now_us());
+}
+
+static void on_accept(int server_fd)
+{
+    for (;;)
     {
-        memset(buffer, 0, BUFFER_SIZE);
-        n = read(client_fd, buffer, BUFFER_SIZE - 1);
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int fd = accept4(server_fd, (struct sockaddr*)&client_addr, &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("Accept failed");
+            return;
+        }
         
-        if (n <= 0)
+        struct conn *c = add_client(fd);
+        if (!c)
         {
-            printf("Client disconnected (FD: %d, ID: %s)\n", client_fd, client_id);
-            break;
+            log_msg(LOG_WARN, "Too many clients, rejecting %s:%d\n",
+                   inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
+            close(fd);
+            continue;
         }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        epoll_set(fd, fd, EPOLLIN, EPOLL_CTL_ADD);
         
-        buffer[n] = '\0';
-        printf("\n[FROM %s(FD:%d)]: %s", client_id, client_fd, buffer);
+        log_msg(LOG_INFO, "New connection from %s:%d\n",
+                inet_ntoa(client_addr.sin_addr),
+                ntohs(client_addr.sin_port));
+        log_msg(LOG_INFO, "Client connected (FD: %d)\n", fd);
+    }
+}
+
+// UDP 데이터그램: [token | frame], 토큰 해시로 TCP 연결을 찾고 오래된 seq 는 버림
+static void on_udp_readable(int udp_fd)
+{
+    uint8_t dgram[64];
+    
+    for (;;)
+    {
+        ssize_t n = recv(udp_fd, dgram, sizeof(dgram), 0);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                perror("UDP recv");
+            return;
+        }
+        int64_t recv_us = now_us();
         
-        // 모든 메시지를 다른 클라이언트에게 브로드캐스트
-        broadcast_to_all(buffer, client_fd);
+        struct led_frame f;
+        uint32_t token = 0;
+        if (n == LED_UDP_DATAGRAM_SIZE)
+            token = ((uint32_t)dgram[0] << 24) | ((uint32_t)dgram[1] << 16) |
+                    ((uint32_t)dgram[2] << 8) | dgram[3];
+        if (token == 0 || led_frame_decode(dgram + 4, LED_FRAME_SIZE, &f) != LED_FRAME_SIZE)
+        {
+            udp_bad++;
+            continue;
+        }
         
-        // LED 데이터 처리
-        if (strstr(buffer, "LED@"))
+        struct conn *c = token_find(token);
+        if (!c || c->dead)
         {
-            char *led_str = strstr(buffer, "LED@");
-            led_str += 4;
-            
-            unsigned char dial_value = 0;
-            if (strncmp(led_str, "0x", 2) == 0)
-            {
-                dial_value = (unsigned char)strtoul(led_str, NULL, 16);
-            }
-            else
-            {
-                dial_value = (unsigned char)atoi(led_str);
-            }
-            
-            unsigned char led_pattern = value_to_led_pattern(dial_value);
-            print_led_status(dial_value, led_pattern);
-            
-            // LED 디바이스에 쓰기
-            if (dev_fd >= 0)
-            {
-                write(dev_fd, &led_pattern, sizeof(led_pattern));
-                
-                // LED 변경 알림을 모든 클라이언트에게 전송
-                char notify[100];
-                snprintf(notify, sizeof(notify), "[SERVER]LED_UPDATE@0x%02x\n", dial_value);
-                send_to_all(notify);
-            }
+            udp_bad++;
+            continue;
         }
-        // 일반 메시지 처리
-        else if (strstr(buffer, "[ALLMSG]") || strstr(buffer, "["))
+        if (!seq_account(&c->udp_last_seq, f.seq, &udp_lost))
         {
-            printf("Broadcasting message to all clients\n");
-            // 이미 broadcast_to_all로 전송됨
+            udp_stale++;
+            continue;
         }
+        udp_rx++;
+        struct led_batch batch = { .pending = 1, .binary = 1, .udp = 1, .f = f };
+        memcpy(batch.raw, dgram + 4, LED_FRAME_SIZE);
+        led_batch_flush(c, &batch, recv_us);
     }
-    
-    remove_client(client_fd);
-    close(client_fd);
-    free(arg);
-    return NULL;
 }
 
-int main()
+static void on_signal(int sig_fd)
 {
-    int server_fd, *client_fd;
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    pthread_t thread_id;
-    
-    // 클라이언트 배열 초기화
-    memset(client_fds, 0, sizeof(client_fds));
+    struct signalfd_siginfo si;
+    while (read(sig_fd, &si, sizeof(si)) == sizeof(si))
+    {
+        if (si.ssi_signo == SIGUSR1)
+            print_latency_stats();
+    }
+}
+
+static int parse_policy(const char *s)
+{
+    if (strcmp(s, "coalesce") == 0) return POLICY_COALESCE;
+    if (strcmp(s, "drop") == 0) return POLICY_DROP;
+    if (strcmp(s, "disconnect") == 0) return POLICY_DISCONNECT;
+    fprintf(stderr, "unknown policy '%s' (coalesce|drop|disconnect)\n", s);
+    exit(1);
+}
+
+// "HZ" 또는 "HZ:BURST" (HZ 0 = 제한 없음)
+static void parse_rate(const char *s, struct rate_limit *r)
+{
+    r->rate = atof(s);
+    const char *colon = strchr(s, ':');
+    r->burst = colon ? atof(colon + 1) : r->burst;
+    if (r->burst < 1.0)
+        r->burst = 1.0;
+}
+
+static int parse_log_level(const char *s)
+{
+    if (strcmp(s, "error") == 0) return LOG_ERROR;
+    if (strcmp(s, "warn") == 0) return LOG_WARN;
+    if (strcmp(s, "info") == 0) return LOG_INFO;
+    if (strcmp(s, "debug") == 0) return LOG_DEBUG;
+    fprintf(stderr, "unknown log level '%s' (error|warn|info|debug)\n", s);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    int server_fd;
+    struct sockaddr_in server_addr;
+    int log_lv = LOG_INFO;
+    int log_sample = 1;
+    const char *log_bin_path = NULL;
+    const char *sink_spec = NULL;
+    int port = PORT;
     
-    // LED 디바이스 열기
-    if (access(DEVICE_FILENAME, F_OK) != 0)
+    for (int i = 1; i < argc; i++)
     {
-        int ret = mknod(DEVICE_FILENAME, S_IRWXU | S_IRWXG | S_IFCHR, (230 << 8) | 0);
-        if (ret < 0)
+        if (strncmp(argv[i], "--port=", 7) == 0)
+            port = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--outbuf-kb=", 12) == 0)
+            outbuf_limit = (size_t)atoi(argv[i] + 12) * 1024;
+        else if (strncmp(argv[i], "--led-policy=", 13) == 0)
+            class_policy[MSG_LED_CMD] = class_policy[MSG_LED_UPDATE] = parse_policy(argv[i] + 13);
+        else if (strncmp(argv[i], "--chat-policy=", 14) == 0)
         {
-            perror("mknod()");
+            class_policy[MSG_CHAT] = parse_policy(argv[i] + 14);
+            if (class_policy[MSG_CHAT] == POLICY_COALESCE)   // 채팅은 합칠 수 없음
+                class_policy[MSG_CHAT] = POLICY_DROP;
         }
+        else if (strncmp(argv[i], "--sink=", 7) == 0)
+            sink_spec = argv[i] + 7;
+        else if (strncmp(argv[i], "--led-rate=", 11) == 0)
+            parse_rate(argv[i] + 11, &led_limit);
+        else if (strncmp(argv[i], "--chat-rate=", 12) == 0)
+            parse_rate(argv[i] + 12, &chat_limit);
+        else if (strncmp(argv[i], "--tick-hz=", 10) == 0)
+            tick_hz = atoi(argv[i] + 10);
+        else if (strncmp(argv[i], "--update-max-hz=", 16) == 0)
+            update_max_hz = atoi(argv[i] + 16);
+        else if (strncmp(argv[i], "--dev-max-hz=", 13) == 0)
+            dev_max_hz = atoi(argv[i] + 13);
+        else if (strncmp(argv[i], "--log-level=", 12) == 0)
+            log_lv = parse_log_level(argv[i] + 12);
+        else if (strncmp(argv[i], "--log-sample=", 13) == 0)
+            log_sample = atoi(argv[i] + 13);
+        else if (strncmp(argv[i], "--log-binary=", 13) == 0)
+            log_bin_path = argv[i] + 13;
     }
     
-    dev_fd = open(DEVICE_FILENAME, O_RDWR | O_NDELAY);
-    if (dev_fd < 0)
+    // 연결 수만큼 fd 가 필요하므로 소프트 한도를 하드 한도까지 올림
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
     {
-        perror("Device open failed");
-        printf("Warning: Running without hardware device - Simulation mode\n");
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
     }
-    else
+    
+    // SIGUSR1 은 signalfd 로 이벤트 루프에서 처리 (kill -USR1 <pid> 로 지연 통계 출력)
+    sigset_t sig_set;
+    sigemptyset(&sig_set);
+    sigaddset(&sig_set, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &sig_set, NULL);
+    int sig_fd = signalfd(-1, &sig_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    
+    // 로그는 flusher 스레드가 내보냄 (SIGUSR1 을 막은 뒤 만들어야 스레드가 시그널을 받지 않음)
+    if (log_ring_init(log_lv, log_sample, log_bin_path) < 0)
+        return -1;
+    
+    // LED sink 열기. 지정하지 않았는데 디바이스가 없으면 null sink 로 (알림 등 나머지는 동일)
+    if (led_sink_open(&sink, sink_spec ? sink_spec : "dev") < 0)
+    {
+        if (sink_spec)
+            return -1;
+        printf("Warning: Running without hardware device - Simulation mode (--sink=shm to observe LED state)\n");
+        led_sink_open(&sink, "null");
+    }
+    
+    pthread_t writer;
+    dev_wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (dev_wake_fd < 0 || pthread_create(&writer, NULL, dev_writer_thread, NULL) != 0)
     {
-        printf("Device opened successfully\n");
-        unsigned char led_off = 0;
-        write(dev_fd, &led_off, sizeof(led_off));
+        perror("LED writer thread");
+        return -1;
     }
+    pthread_detach(writer);
     
     // 소켓 생성
     server_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -277,7 +1603,7 @@ int main()
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(PORT);
+    server_addr.sin_port = htons(port);
     
     if (bind(server_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0)
     {
@@ -286,48 +1612,111 @@ int main()
         return -1;
     }
     
-    if (listen(server_fd, 5) < 0)
+    if (listen(server_fd, 128) < 0)
     {
         perror("Listen failed");
         close(server_fd);
         return -1;
     }
+    set_nonblock(server_fd);
+    
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0)
+    {
+        perror("epoll_create1");
+        return -1;
+    }
+    epoll_set(server_fd, EV_LISTEN, EPOLLIN, EPOLL_CTL_ADD);
+    if (sig_fd >= 0)
+        epoll_set(sig_fd, EV_SIGNAL, EPOLLIN, EPOLL_CTL_ADD);
+    
+    // tick 모드: 고정 주기 timerfd 로 모아 둔 송신을 내보냄
+    int tick_fd = -1;
+    if (tick_hz > 0)
+    {
+        tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        long period_ns = 1000000000L / tick_hz;
+        struct itimerspec its = { { period_ns / 1000000000L, period_ns % 1000000000L },
+                                  { period_ns / 1000000000L, period_ns % 1000000000L } };
+        if (tick_fd < 0 || timerfd_settime(tick_fd, 0, &its, NULL) < 0)
+        {
+            perror("timerfd");
+            return -1;
+        }
+        epoll_set(tick_fd, EV_TICK, EPOLLIN, EPOLL_CTL_ADD);
+    }
+    
+    // LED 값 전용 UDP 채널 (같은 포트)
+    int udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (udp_fd < 0 || bind(udp_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0)
+    {
+        perror("UDP bind failed");
+        if (udp_fd >= 0)
+            close(udp_fd);
+    }
+    else
+    {
+        epoll_set(udp_fd, EV_UDP, EPOLLIN, EPOLL_CTL_ADD);
+    }
     
     printf("\n===== LED Control Server (Broadcast Mode) =====\n");
-    printf("Port: %d\n", PORT);
-    printf("All messages will be broadcast to other clients\n");
+    printf("Port: %d\n", port);
+    printf("Addressed messages are routed, [ALLMSG] is broadcast\n");
+    printf("LED sink: %s, writes max %d Hz\n", sink.name, dev_max_hz);
+    if (update_max_hz > 0)
+        printf("LED_UPDATE per subscriber: max %d Hz\n", update_max_hz);
+    if (tick_hz > 0)
+        printf("Tick mode: %d Hz, one writev per client per tick\n", tick_hz);
+    printf("Rate limit per client: LED %.0f/s (burst %.0f), chat %.0f/s (burst %.0f)\n",
+           led_limit.rate, led_limit.burst, chat_limit.rate, chat_limit.burst);
     printf("===============================================\n");
     printf("Waiting for connections...\n\n");
     
+    struct epoll_event events[MAX_EVENTS];
     while (1)
     {
-        client_fd = malloc(sizeof(int));
-        *client_fd = accept(server_fd, (struct sockaddr*)&client_addr, &client_len);
-        
-        if (*client_fd < 0)
+        // 보류한 LED 명령 / 상태 메시지가 있으면 가장 이른 처리 시각까지만 기다림
+        int timeout = release_deferred_led();
+        int held_ms = release_held_state();
+        if (held_ms >= 0 && (timeout < 0 || held_ms < timeout))
+            timeout = held_ms;
+        int n = epoll_wait(epfd, events, MAX_EVENTS, timeout);
+        if (n < 0)
         {
-            perror("Accept failed");
-            free(client_fd);
-            continue;
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait");
+            break;
         }
         
-        printf("New connection from %s:%d\n", 
-               inet_ntoa(client_addr.sin_addr), 
-               ntohs(client_addr.sin_port));
-        
-        if (pthread_create(&thread_id, NULL, handle_client, client_fd) != 0)
+        for (int i = 0; i < n; i++)
         {
-            perror("Thread creation failed");
-            close(*client_fd);
-            free(client_fd);
+            int64_t tag = (int64_t)events[i].data.u64;
+            if (tag == EV_LISTEN)
+                on_accept(server_fd);
+            else if (tag == EV_UDP)
+                on_udp_readable(udp_fd);
+            else if (tag == EV_SIGNAL)
+                on_signal(sig_fd);
+            else if (tag == EV_TICK)
+                on_tick(tick_fd);
+            else
+            {
+                struct conn *c = conns[tag];
+                if (!c || c->dead)
+                    continue;
+                if (events[i].events & EPOLLOUT)
+                    conn_flush(c);
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    on_client_readable(c);
+            }
         }
-        
-        pthread_detach(thread_id);
+        reap_dead();
     }
     
     close(server_fd);
-    if (dev_fd >= 0)
-        close(dev_fd);
+    sink.close(&sink);
+    log_ring_stop();
     
     return 0;
-}
\ No newline at end of file
+}
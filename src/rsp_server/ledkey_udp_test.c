@@ -0,0 +1,325 @@
+// ledkey_server UDP LED 채널 루프백 테스트: 손실/역순 내성과 지연을 TCP 경로와 비교
+//
+// 서버를 --sink=null --led-rate=0 으로 띄운 뒤 바이너리 로그인("id:pw:BIN1\n")으로 UDP 토큰을 받고,
+// 같은 연결로 LED 값을 약 1 kHz 로 세 구간에 나눠 보낸다.
+//   tcp   : TCP 프레임
+//   udp   : UDP 데이터그램 [token | frame]
+//   lossy : UDP, 10% 는 보내지 않고(손실) 5% 는 다음 값 뒤에 보냄(역순)
+// 지연은 프레임 송신 -> 같은 seq 의 LED_UPDATE 프레임 수신. 역순으로 늦게 도착한 값이 반영되면
+// (오래된 값이 최신 상태를 덮음) 실패, UDP 구간에서 보낸 새 값이 반영되지 않아도 실패.
+//
+//   ./ledkey_udp_test                          (./ledkey_server, 포트 5601)
+//   ./ledkey_udp_test --server=PATH --port=N --count=2000
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "led_frame.h"
+#include "hist.h"
+
+#define RX_BUF 8192
+#define SEND_INTERVAL_US 1000       // 약 1 kHz
+#define DRAIN_US 300000             // 구간 끝에서 남은 알림을 기다리는 시간
+#define LOSS_PCT 10
+#define REORDER_PCT 5
+
+enum phase_mode { PHASE_TCP, PHASE_UDP, PHASE_LOSSY };
+
+struct phase
+{
+    const char *name;
+    int mode;
+    struct lat_hist hist;
+    int sent;               // 서버로 나간 값
+    int dropped;            // 일부러 보내지 않은 값 (lossy)
+    int late;               // 다음 값 뒤에 보낸 값 (lossy)
+    int acked;              // 반영된(LED_UPDATE 가 온) 값
+    int late_applied;       // 늦게 보냈는데 반영된 값 (실패)
+};
+
+static const char *server_path = "./ledkey_server";
+static int port = 5601;
+static int count = 2000;
+static pid_t server_pid = -1;
+
+static int tcp_fd = -1;
+static int udp_fd = -1;
+static uint32_t token;
+static uint8_t rx[RX_BUF];
+static int rx_len;
+
+// seq -> 송신 시각 (0 = 대기 없음), 늦게 보낸 값 표시
+static int64_t send_us[65536];
+static uint8_t is_late[65536];
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int start_server(void)
+{
+    char port_arg[32];
+    snprintf(port_arg, sizeof(port_arg), "--port=%d", port);
+    server_pid = fork();
+    if (server_pid < 0)
+        return -1;
+    if (server_pid == 0)
+    {
+        if (!freopen("/dev/null", "w", stdout))
+            _exit(127);
+        execl(server_path, server_path, port_arg, "--sink=null", "--log-level=warn", "--led-rate=0",
+              (char *)NULL);
+        _exit(127);
+    }
+    return 0;
+}
+
+static void stop_server(void)
+{
+    if (server_pid > 0)
+    {
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, NULL, 0);
+    }
+}
+
+// 바이너리 로그인 후 응답 줄에서 UDP 토큰을 받고 UDP 소켓을 연결
+static int connect_login(void)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int64_t deadline = now_us() + 2000000;
+    for (;;)
+    {
+        tcp_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(tcp_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+            break;
+        close(tcp_fd);
+        if (now_us() > deadline)
+            return -1;
+        usleep(20000);
+    }
+    int one = 1;
+    setsockopt(tcp_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    const char *login = "udptest:PASSWD:" LED_PROTO_BIN_TAG "\n";
+    if (send(tcp_fd, login, strlen(login), 0) != (ssize_t)strlen(login))
+        return -1;
+
+    // 응답 줄만 읽음 (뒤의 스냅샷 프레임은 rx 로)
+    char line[128];
+    int len = 0;
+    while (len < (int)sizeof(line) - 1)
+    {
+        if (recv(tcp_fd, line + len, 1, 0) != 1)
+            return -1;
+        if (line[len++] == '\n')
+            break;
+    }
+    line[len] = '\0';
+    const char *tag = strstr(line, LED_UDP_TAG);
+    if (!tag)
+    {
+        fprintf(stderr, "no UDP token in reply: %s", line);
+        return -1;
+    }
+    token = (uint32_t)strtoul(tag + strlen(LED_UDP_TAG), NULL, 16);
+
+    udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd < 0 || connect(udp_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        return -1;
+    return 0;
+}
+
+static void send_value(struct phase *ph, uint16_t seq, int64_t now)
+{
+    struct led_frame f = { .type = LED_FRAME_SET, .value = (uint8_t)seq, .seq = seq, .ts_us = (uint64_t)now };
+    uint8_t dgram[LED_UDP_DATAGRAM_SIZE];
+    dgram[0] = (uint8_t)(token >> 24);
+    dgram[1] = (uint8_t)(token >> 16);
+    dgram[2] = (uint8_t)(token >> 8);
+    dgram[3] = (uint8_t)token;
+    led_frame_encode(&f, dgram + 4);
+    send_us[seq] = now;
+    if (ph->mode == PHASE_TCP)
+        send(tcp_fd, dgram + 4, LED_FRAME_SIZE, 0);
+    else
+        send(udp_fd, dgram, LED_UDP_DATAGRAM_SIZE, 0);
+    ph->sent++;
+}
+
+// TCP 수신을 timeout_us 동안 처리. LED_UPDATE 프레임의 seq 로 매칭
+static void poll_updates(struct phase *ph, int64_t timeout_us)
+{
+    struct pollfd pfd = { .fd = tcp_fd, .events = POLLIN };
+    struct timespec ts = { timeout_us / 1000000, (timeout_us % 1000000) * 1000 };
+    if (ppoll(&pfd, 1, &ts, NULL) <= 0)
+        return;
+    int n = recv(tcp_fd, rx + rx_len, RX_BUF - rx_len, MSG_DONTWAIT);
+    if (n <= 0)
+        return;
+    rx_len += n;
+    int64_t now = now_us();
+
+    int pos = 0;
+    while (pos < rx_len)
+    {
+        if (rx[pos] != LED_FRAME_MAGIC0)
+        {
+            // 텍스트 줄 (이 테스트에는 없어야 하지만 건너뜀)
+            uint8_t *nl = memchr(rx + pos, '\n', rx_len - pos);
+            if (!nl)
+                break;
+            pos = (int)(nl - rx) + 1;
+            continue;
+        }
+        struct led_frame f;
+        int r = led_frame_decode(rx + pos, rx_len - pos, &f);
+        if (r == 0)
+            break;
+        if (r < 0)
+        {
+            pos++;
+            continue;
+        }
+        pos += r;
+        if (f.type != LED_FRAME_UPDATE || (f.flags & LED_FLAG_SNAPSHOT) || !send_us[f.seq])
+            continue;
+        if (is_late[f.seq])
+            ph->late_applied++;
+        hist_add(&ph->hist, now - send_us[f.seq]);
+        send_us[f.seq] = 0;
+        ph->acked++;
+    }
+    memmove(rx, rx + pos, rx_len - pos);
+    rx_len -= pos;
+}
+
+static void run_phase(struct phase *ph, uint16_t *seq)
+{
+    int64_t next = now_us();
+    int held = -1;          // 역순으로 보낼 값 (다음 값 뒤에)
+    for (int i = 0; i < count; i++)
+    {
+        uint16_t s = ++*seq;
+        if (s == 0)
+            s = ++*seq;
+        int64_t now = now_us();
+        if (ph->mode == PHASE_LOSSY && rand() % 100 < LOSS_PCT)
+        {
+            ph->dropped++;
+        }
+        else if (ph->mode == PHASE_LOSSY && held < 0 && rand() % 100 < REORDER_PCT)
+        {
+            held = s;
+            is_late[s] = 1;
+            ph->late++;
+        }
+        else
+        {
+            send_value(ph, s, now);
+            if (held >= 0)
+            {
+                send_value(ph, (uint16_t)held, now);
+                held = -1;
+            }
+        }
+        next += SEND_INTERVAL_US;
+        int64_t wait = next - now_us();
+        while (wait > 0)
+        {
+            poll_updates(ph, wait);
+            wait = next - now_us();
+        }
+    }
+    if (held >= 0)
+        send_value(ph, (uint16_t)held, now_us());
+    int64_t end = now_us() + DRAIN_US;
+    while (now_us() < end)
+        poll_updates(ph, end - now_us());
+}
+
+static void report(const struct phase *ph)
+{
+    int fresh = ph->sent - ph->late;
+    printf("%-6s sent %5d  dropped %4d  late %3d  applied %5d/%d fresh (%.1f%%)  late applied %d  "
+           "latency p50 %5lld us  p99 %5lld us  max %6lld us\n",
+           ph->name, ph->sent, ph->dropped, ph->late, ph->acked - ph->late_applied, fresh,
+           fresh ? 100.0 * (ph->acked - ph->late_applied) / fresh : 0.0, ph->late_applied,
+           (long long)hist_percentile(&ph->hist, 50), (long long)hist_percentile(&ph->hist, 99),
+           (long long)ph->hist.max);
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--server=", 9) == 0)
+            server_path = argv[i] + 9;
+        else if (strncmp(argv[i], "--port=", 7) == 0)
+            port = atoi(argv[i] + 7);
+        else if (strncmp(argv[i], "--count=", 8) == 0)
+            count = atoi(argv[i] + 8);
+        else
+        {
+            fprintf(stderr, "usage: %s [--server=PATH] [--port=N] [--count=N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count <= 0 || count > 20000)
+        count = 2000;
+    signal(SIGPIPE, SIG_IGN);
+    srand(1);
+
+    if (start_server() < 0 || connect_login() < 0)
+    {
+        fprintf(stderr, "server start/login failed\n");
+        stop_server();
+        return 1;
+    }
+
+    struct phase phases[] = {
+        { .name = "tcp", .mode = PHASE_TCP, .hist = { .name = "tcp" } },
+        { .name = "udp", .mode = PHASE_UDP, .hist = { .name = "udp" } },
+        { .name = "lossy", .mode = PHASE_LOSSY, .hist = { .name = "lossy" } },
+    };
+    uint16_t seq = 0;
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++)
+    {
+        struct phase *ph = &phases[i];
+        run_phase(ph, &seq);
+        report(ph);
+        // UDP 는 한 데이터그램씩 반영하므로 새 값은 모두 반영되어야 함 (TCP 는 read 묶음에서 덮일 수 있음)
+        if (ph->mode != PHASE_TCP && ph->acked - ph->late_applied < ph->sent - ph->late)
+            failures++;
+        if (ph->late_applied)
+            failures++;
+    }
+
+    close(udp_fd);
+    close(tcp_fd);
+    stop_server();
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+}
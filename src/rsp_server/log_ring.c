@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
+#include "log_ring.h"
+
+#define LOG_RING_SLOTS 4096         // 2의 거듭제곱
+#define LOG_SLOT_DATA 240           // 텍스트 한 줄 최대 길이 (넘으면 잘림)
+
+enum { SLOT_TEXT, SLOT_RECORD };
+
+// 다중 생산자 / 단일 소비자 링 (슬롯마다 seq 로 소유권 표시)
+//   seq == pos     : 비어 있음, 생산자가 pos 를 차지할 수 있음
+//   seq == pos + 1 : 채워짐, 소비자가 읽을 수 있음
+struct log_slot
+{
+    uint64_t seq;
+    uint16_t kind;
+    uint16_t len;
+    char data[LOG_SLOT_DATA];
+};
+
+static struct log_slot ring[LOG_RING_SLOTS];
+static uint64_t enq_pos;            // 생산자 공유 (__atomic)
+static uint64_t deq_pos;            // flusher 전용
+
+int log_level = LOG_INFO;
+static int sample_n = 1;
+static uint64_t sample_cnt;
+static FILE *bin_fp;
+static pthread_t flusher;
+static int running;
+// flusher 는 링이 비면 eventfd 에서 잠든다. 잠들기 전 flusher_idle 을 세우고, 그 뒤 처음 게시한
+// 생산자(링이 빈 상태 -> 채워짐)만 flusher_idle 을 내리고 eventfd 로 깨운다
+static int wake_fd = -1;
+static int flusher_idle;
+
+static uint64_t n_lines, n_records, n_dropped, n_sampled_out;
+
+static int64_t log_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// 슬롯 하나 차지. 가득 차면 NULL (버림)
+static struct log_slot *slot_acquire(uint64_t *pos_out)
+{
+    uint64_t pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        struct log_slot *s = &ring[pos & (LOG_RING_SLOTS - 1)];
+        uint64_t seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&enq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *pos_out = pos;
+                return s;
+            }
+        }
+        else if (diff < 0)
+        {
+            __atomic_fetch_add(&n_dropped, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        else
+        {
+            pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void slot_publish(struct log_slot *s, uint64_t pos)
+{
+    __atomic_store_n(&s->seq, pos + 1, __ATOMIC_SEQ_CST);
+    // seq 게시와 flusher_idle 확인 순서가 flusher 쪽(idle 설정 -> seq 재확인)과 엇갈리지 않게 SEQ_CST
+    if (__atomic_load_n(&flusher_idle, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&flusher_idle, 0, __ATOMIC_SEQ_CST))
+    {
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+            perror("log eventfd write");
+    }
+}
+
+// 다음 슬롯이 채워져 있는지 (flusher 전용)
+static int ring_ready(void)
+{
+    struct log_slot *s = &ring[deq_pos & (LOG_RING_SLOTS - 1)];
+    return __atomic_load_n(&s->seq, __ATOMIC_SEQ_CST) == deq_pos + 1;
+}
+
+void log_msg(int level, const char *fmt, ...)
+{
+    if (level > log_level)
+        return;
+    uint64_t pos;
+    struct log_slot *s = slot_acquire(&pos);
+    if (!s)
+        return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s->data, LOG_SLOT_DATA, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        n = 0;
+    if (n >= LOG_SLOT_DATA)
+    {
+        // 잘린 줄도 개행으로 끝나게
+        n = LOG_SLOT_DATA - 1;
+        s->data[n - 1] = '\n';
+    }
+    s->kind = SLOT_TEXT;
+    s->len = (uint16_t)n;
+    slot_publish(s, pos);
+}
+
+int log_hot(uint16_t type, int fd, uint32_t value, uint32_t aux)
+{
+    if (bin_fp)
+    {
+        uint64_t pos;
+        struct log_slot *s = slot_acquire(&pos);
+        if (!s)
+            return 0;
+        struct log_record r = { .ts_us = (uint64_t)log_now_us(), .type = type,
+                                .fd = fd, .value = value, .aux = aux };
+        memcpy(s->data, &r, sizeof(r));
+        s->kind = SLOT_RECORD;
+        s->len = sizeof(r);
+        slot_publish(s, pos);
+        return 0;
+    }
+    if (log_level < LOG_INFO)
+        return 0;
+    if (sample_n > 1 &&
+        __atomic_fetch_add(&sample_cnt, 1, __ATOMIC_RELAXED) % (uint64_t)sample_n != 0)
+    {
+        __atomic_fetch_add(&n_sampled_out, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    return 1;
+}
+
+// 채워진 슬롯을 순서대로 꺼내 내보냄. 꺼낸 슬롯 수 반환
+static int drain(void)
+{
+    static char out[64 * 1024];
+    size_t out_len = 0;
+    int n = 0;
+
+    for (;;)
+    {
+        struct log_slot *s = &ring[deq_pos & (LOG_RING_SLOTS - 1)];
+        if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != deq_pos + 1)
+            break;
+        if (s->kind == SLOT_RECORD)
+        {
+            fwrite(s->data, 1, s->len, bin_fp);
+            __atomic_fetch_add(&n_records, 1, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            if (out_len + s->len > sizeof(out))
+            {
+                fwrite(out, 1, out_len, stdout);
+                out_len = 0;
+            }
+            memcpy(out + out_len, s->data, s->len);
+            out_len += s->len;
+            __atomic_fetch_add(&n_lines, 1, __ATOMIC_RELAXED);
+        }
+        // 다음 바퀴에서 생산자가 쓸 수 있게 비움 표시
+        __atomic_store_n(&s->seq, deq_pos + LOG_RING_SLOTS, __ATOMIC_RELEASE);
+        deq_pos++;
+        n++;
+    }
+
+    if (out_len)
+        fwrite(out, 1, out_len, stdout);
+    if (n)
+    {
+        fflush(stdout);
+        if (bin_fp)
+            fflush(bin_fp);
+    }
+    return n;
+}
+
+static void *flusher_thread(void *arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+    {
+        if (drain() > 0)
+            continue;
+        // 잠들기 전에 idle 을 세우고 다시 확인: 그 사이 게시된 슬롯이 있으면 깨움을 기다리지 않음
+        __atomic_store_n(&flusher_idle, 1, __ATOMIC_SEQ_CST);
+        if (ring_ready() || !__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+        {
+            __atomic_store_n(&flusher_idle, 0, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        uint64_t cnt;
+        while (read(wake_fd, &cnt, sizeof(cnt)) < 0 && errno == EINTR)
+            ;
+        __atomic_store_n(&flusher_idle, 0, __ATOMIC_SEQ_CST);
+    }
+    drain();
+    return NULL;
+}
+
+int log_ring_init(int level, int sample, const char *binary_path)
+{
+    log_level = level;
+    sample_n = sample > 0 ? sample : 1;
+    for (uint64_t i = 0; i < LOG_RING_SLOTS; i++)
+        ring[i].seq = i;
+
+    if (binary_path)
+    {
+        bin_fp = fopen(binary_path, "wb");
+        if (!bin_fp)
+        {
+            perror("log binary file");
+            return -1;
+        }
+    }
+
+    wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0)
+    {
+        perror("log eventfd");
+        return -1;
+    }
+    running = 1;
+    if (pthread_create(&flusher, NULL, flusher_thread, NULL) != 0)
+    {
+        running = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void log_ring_stop(void)
+{
+    if (!running)
+        return;
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0)
+        perror("log eventfd write");
+    pthread_join(flusher, NULL);
+    close(wake_fd);
+    wake_fd = -1;
+    if (bin_fp)
+        fclose(bin_fp);
+    bin_fp = NULL;
+}
+
+void log_ring_stats(uint64_t *lines, uint64_t *records, uint64_t *dropped, uint64_t *sampled_out)
+{
+    *lines = __atomic_load_n(&n_lines, __ATOMIC_RELAXED);
+    *records = __atomic_load_n(&n_records, __ATOMIC_RELAXED);
+    *dropped = __atomic_load_n(&n_dropped, __ATOMIC_RELAXED);
+    *sampled_out = __atomic_load_n(&n_sampled_out, __ATOMIC_RELAXED);
+}
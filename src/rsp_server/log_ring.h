@@ -0,0 +1,54 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+
+// 비동기 로그: 호출 스레드는 고정 크기 슬롯에 기록만 하고(잠금 없는 다중 생산자 링),
+// 백그라운드 flusher 스레드가 모아서 stdout / 바이너리 파일로 내보낸다.
+// 링이 가득 차면 기다리지 않고 버린 뒤 수만 센다.
+
+enum log_level
+{
+    LOG_ERROR,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG,
+};
+
+// 바이너리 모드 이벤트 종류 (log_event)
+enum log_event_type
+{
+    LOG_EV_LED_TEXT = 1,    // 텍스트 LED 명령 (value, aux = 0)
+    LOG_EV_LED_FRAME,       // TCP 바이너리 프레임 (value, aux = seq)
+    LOG_EV_LED_UDP,         // UDP 데이터그램 (value, aux = seq)
+};
+
+// 바이너리 레코드 (파일에 그대로 기록, 호스트 엔디언)
+struct log_record
+{
+    uint64_t ts_us;         // CLOCK_MONOTONIC
+    uint16_t type;
+    uint16_t reserved;
+    int32_t fd;
+    uint32_t value;
+    uint32_t aux;
+};
+
+// level 이하만 기록. sample_n: 고빈도 LED 로그를 n 개 중 하나만 텍스트로 (1 = 전부).
+// binary_path 가 있으면 고빈도 이벤트는 텍스트 대신 log_record 로 그 파일에 기록.
+// 반환: 0 성공, -1 실패
+int log_ring_init(int level, int sample_n, const char *binary_path);
+// 남은 로그를 모두 내보내고 flusher 종료
+void log_ring_stop(void);
+
+extern int log_level;
+
+void log_msg(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// 고빈도 이벤트 기록 여부. 바이너리 모드면 레코드를 남기고 0, 텍스트면 샘플링에 걸린 경우만 1
+int log_hot(uint16_t type, int fd, uint32_t value, uint32_t aux);
+
+// 통계: 내보낸 텍스트 줄 / 바이너리 레코드, 링이 가득 차 버린 수, 샘플링으로 생략한 수
+void log_ring_stats(uint64_t *lines, uint64_t *records, uint64_t *dropped, uint64_t *sampled_out);
+
+#endif // LOG_RING_H